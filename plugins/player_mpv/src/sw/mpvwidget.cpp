@@ -0,0 +1,231 @@
+#include "mpvwidget.h"
+#include <stdexcept>
+
+// matches QImage::Format_RGB32 in memory
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+static const char *SW_FORMAT = "bgr0";
+#else
+static const char *SW_FORMAT = "0rgb";
+#endif
+
+static void wakeup(void *ctx) {
+    QMetaObject::invokeMethod((MpvWidget*)ctx, "on_mpv_events", Qt::QueuedConnection);
+}
+
+MpvWidget::MpvWidget(QWidget *parent, Qt::WindowFlags f)
+    : QWidget(parent, f),
+      mpv_sw(nullptr),
+      renderThread(nullptr),
+      updatePending(false),
+      framePending(false),
+      abort(false)
+{
+    mpv = mpv_create();
+    if(!mpv)
+        throw std::runtime_error("could not create mpv context");
+
+    this->setAttribute(Qt::WA_TransparentForMouseEvents, true);
+    // every pixel is covered by the frame
+    this->setAttribute(Qt::WA_OpaquePaintEvent, true);
+
+    //mpv_set_option_string(mpv, "terminal", "yes");
+    //mpv_set_option_string(mpv, "msg-level", "all=v");
+
+    if (mpv_initialize(mpv) < 0)
+        throw std::runtime_error("could not initialize mpv context");
+
+    // frames must end up in system memory anyway
+    mpv::qt::set_property(mpv, "hwdec", "auto-copy");
+
+    // Loop video
+    setRepeat(true);
+
+    // Unmute
+    setMuted(false);
+
+    mpv_observe_property(mpv, 0, "duration", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, 0, "time-pos", MPV_FORMAT_DOUBLE);
+    mpv_observe_property(mpv, 0, "pause", MPV_FORMAT_FLAG);
+    mpv_set_wakeup_callback(mpv, wakeup, this);
+
+    mpv_render_param params[]{
+        {MPV_RENDER_PARAM_API_TYPE, const_cast<char *>(MPV_RENDER_API_TYPE_SW)},
+        {MPV_RENDER_PARAM_INVALID, nullptr}
+    };
+    if(mpv_render_context_create(&mpv_sw, mpv, params) < 0)
+        throw std::runtime_error("failed to initialize mpv software renderer");
+    mpv_render_context_set_update_callback(mpv_sw, MpvWidget::on_update, reinterpret_cast<void *>(this));
+
+    renderThread = QThread::create([this]() { renderLoop(); });
+    renderThread->start();
+}
+
+MpvWidget::~MpvWidget() {
+    mutex.lock();
+    abort = true;
+    renderWakeup.wakeAll();
+    mutex.unlock();
+    renderThread->wait();
+    delete renderThread;
+    mpv_render_context_free(mpv_sw);
+    mpv_terminate_destroy(mpv);
+}
+
+void MpvWidget::command(const QVariant& params) {
+    mpv::qt::command(mpv, params);
+}
+
+void MpvWidget::setProperty(const QString& name, const QVariant& value) {
+    mpv::qt::set_property(mpv, name, value);
+}
+
+QVariant MpvWidget::getProperty(const QString &name) const {
+    return mpv::qt::get_property(mpv, name);
+}
+
+void MpvWidget::setOption(const QString& name, const QVariant& value) {
+    mpv::qt::set_property(mpv, name, value);
+}
+
+// Called by mpv from its own threads; no mpv calls allowed here.
+void MpvWidget::on_update(void *ctx) {
+    MpvWidget *widget = reinterpret_cast<MpvWidget*>(ctx);
+    QMutexLocker lock(&widget->mutex);
+    widget->updatePending = true;
+    widget->renderWakeup.wakeOne();
+}
+
+void MpvWidget::renderLoop() {
+    QMutexLocker lock(&mutex);
+    forever {
+        while(!abort && !updatePending)
+            renderWakeup.wait(&mutex);
+        if(abort)
+            return;
+        updatePending = false;
+        QSize size = targetSize;
+        bool resized = (front.size() != size);
+        lock.unlock();
+
+        uint64_t flags = mpv_render_context_update(mpv_sw);
+        if(size.isEmpty() || !((flags & MPV_RENDER_UPDATE_FRAME) || resized)) {
+            lock.relock();
+            continue;
+        }
+        if(back.size() != size)
+            back = QImage(size, QImage::Format_RGB32);
+        int swSize[2] = { size.width(), size.height() };
+        size_t stride = static_cast<size_t>(back.bytesPerLine());
+        mpv_render_param params[] = {
+            {MPV_RENDER_PARAM_SW_SIZE, swSize},
+            {MPV_RENDER_PARAM_SW_FORMAT, const_cast<char *>(SW_FORMAT)},
+            {MPV_RENDER_PARAM_SW_STRIDE, &stride},
+            {MPV_RENDER_PARAM_SW_POINTER, back.bits()},
+            {MPV_RENDER_PARAM_INVALID, nullptr}
+        };
+        mpv_render_context_render(mpv_sw, params);
+
+        lock.relock();
+        front.swap(back);
+        // previous frame was not painted yet: it's replaced, and
+        // a repaint is already on the way
+        if(!framePending) {
+            framePending = true;
+            QMetaObject::invokeMethod(this, "onFrameReady", Qt::QueuedConnection);
+        }
+    }
+}
+
+void MpvWidget::onFrameReady() {
+    update();
+}
+
+void MpvWidget::paintEvent(QPaintEvent *event) {
+    Q_UNUSED(event)
+    QPainter p(this);
+    QMutexLocker lock(&mutex);
+    bool newFrame = framePending;
+    framePending = false;
+    if(front.isNull())
+        p.fillRect(rect(), Qt::black);
+    else
+        p.drawImage(rect(), front);
+    lock.unlock();
+    // helps mpv with frame timing
+    if(newFrame)
+        mpv_render_context_report_swap(mpv_sw);
+}
+
+void MpvWidget::resizeEvent(QResizeEvent *event) {
+    QWidget::resizeEvent(event);
+    QMutexLocker lock(&mutex);
+    targetSize = size() * devicePixelRatioF();
+    // redraw the current frame at the new size
+    updatePending = true;
+    renderWakeup.wakeOne();
+}
+
+void MpvWidget::on_mpv_events() {
+    // Process all events, until the event queue is empty.
+    while (mpv) {
+        mpv_event *event = mpv_wait_event(mpv, 0);
+        if (event->event_id == MPV_EVENT_NONE) {
+            break;
+        }
+        handle_mpv_event(event);
+    }
+}
+
+void MpvWidget::handle_mpv_event(mpv_event *event) {
+    switch (event->event_id) {
+    case MPV_EVENT_PROPERTY_CHANGE: {
+        mpv_event_property *prop = reinterpret_cast<mpv_event_property*>(event->data);
+        if(strcmp(prop->name, "time-pos") == 0) {
+            if (prop->format == MPV_FORMAT_DOUBLE) {
+                double time = *reinterpret_cast<double*>(prop->data);
+                emit positionChanged(static_cast<int>(time));
+            }
+        } else if(strcmp(prop->name, "duration") == 0) {
+            if(prop->format == MPV_FORMAT_DOUBLE) {
+                double time = *reinterpret_cast<double*>(prop->data);
+                emit durationChanged(static_cast<int>(time));
+            } else if(prop->format == MPV_FORMAT_NONE) {
+                emit playbackFinished();
+            }
+        } else if(strcmp(prop->name, "pause") == 0) {
+            int mode = *reinterpret_cast<int*>(prop->data);
+            emit videoPaused(mode == 1);
+        }
+        break;
+    }
+    default: ;
+        // Ignore uninteresting or unknown events.
+    }
+}
+
+void MpvWidget::setMuted(bool mode) {
+    if(mode)
+        mpv::qt::set_property(mpv, "mute", "yes");
+    else
+        mpv::qt::set_property(mpv, "mute", "no");
+}
+
+bool MpvWidget::muted() {
+    return mpv::qt::get_property_variant(mpv, "mute").toBool();
+}
+
+int MpvWidget::volume() {
+    return mpv::qt::get_property_variant(mpv, "volume").toInt();
+}
+
+void MpvWidget::setVolume(int vol) {
+    vol = qBound(0, vol, 100);
+    mpv::qt::set_property_variant(mpv, "volume", vol);
+}
+
+void MpvWidget::setRepeat(bool mode) {
+    if(mode)
+        mpv::qt::set_property(mpv, "loop-file", "inf");
+    else
+        mpv::qt::set_property(mpv, "loop-file", "no");
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QtCore/QMetaObject>
+
+#include <mpv/client.h>
+#include <mpv/render.h>
+#include "qthelper.hpp"
+
+#include <QWidget>
+#include <QObject>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImage>
+#include <QPainter>
+
+// Software rendering version: no OpenGL context needed.
+// mpv renders frames into a QImage on a separate thread, which is then
+// painted like any other widget content.
+class MpvWidget Q_DECL_FINAL : public QWidget {
+    Q_OBJECT
+public:
+    MpvWidget(QWidget *parent = nullptr, Qt::WindowFlags f = Qt::Widget);
+    ~MpvWidget() override;
+
+    void command(const QVariant& params);
+    void setOption(const QString &name, const QVariant &value);
+    void setProperty(const QString& name, const QVariant& value);
+    QVariant getProperty(const QString& name) const;
+
+    void setMuted(bool mode);
+    void setRepeat(bool mode);
+    bool muted();
+    int volume();
+    void setVolume(int vol);
+
+signals:
+    void durationChanged(int value);
+    void positionChanged(int value);
+    void videoPaused(bool);
+    void playbackFinished();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private slots:
+    void on_mpv_events();
+    void onFrameReady();
+
+private:
+    void handle_mpv_event(mpv_event *event);
+    static void on_update(void *ctx);
+    void renderLoop();
+
+    mpv_handle *mpv;
+    mpv_render_context *mpv_sw;
+    QThread *renderThread;
+
+    // Double buffered: the render thread draws into back, then swaps it
+    // with front, which is what paintEvent shows. Both are reused until
+    // the widget size changes.
+    // If painting falls behind, newer frames just replace the one
+    // that is waiting (framePending), so we drop frames instead of lagging.
+    QMutex mutex;
+    QWaitCondition renderWakeup;
+    QImage front, back;
+    QSize targetSize;
+    bool updatePending, framePending, abort;
+};
@@ -1,5 +1,9 @@
 #include "videoplayermpv.h"
+#ifdef MPV_SW_RENDER
+#include "sw/mpvwidget.h"
+#else
 #include "mpvwidget.h"
+#endif
 #include <QPushButton>
 #include <QSlider>
 #include <QLayout>
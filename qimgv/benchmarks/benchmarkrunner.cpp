@@ -0,0 +1,85 @@
+#include "benchmarkrunner.h"
+
+qint64 BenchmarkResult::mean() const {
+    if(samples.isEmpty())
+        return 0;
+    qint64 sum = 0;
+    for(auto s : samples)
+        sum += s;
+    return sum / samples.count();
+}
+
+BenchmarkRunner::BenchmarkRunner(int _iterations, QString filter)
+    : iterations(qMax(_iterations, 1)),
+      filterRegex(filter)
+{
+}
+
+bool BenchmarkRunner::enabled(const QString &suite, const QString &name) const {
+    if(filterRegex.pattern().isEmpty())
+        return true;
+    return filterRegex.match(suite + "/" + name).hasMatch();
+}
+
+void BenchmarkRunner::run(const QString &suite, const QString &name,
+                          std::function<void()> fn, std::function<void()> setup)
+{
+    if(!enabled(suite, name))
+        return;
+    BenchmarkResult result;
+    result.suite = suite;
+    result.name = name;
+    QElapsedTimer t;
+    for(int i = -1; i < iterations; i++) {
+        if(setup)
+            setup();
+        t.start();
+        fn();
+        qint64 elapsed = t.nsecsElapsed() / 1000;
+        if(i >= 0) // first one is the warmup
+            result.samples.append(elapsed);
+    }
+    std::sort(result.samples.begin(), result.samples.end());
+    QTextStream(stderr) << suite << "/" << name << ": " << result.median() / 1000.0 << " ms (median of " << iterations << ")\n";
+    mResults.append(result);
+}
+
+const QVector<BenchmarkResult> &BenchmarkRunner::results() const {
+    return mResults;
+}
+
+QByteArray BenchmarkRunner::toJson(const QJsonObject &environment) const {
+    QJsonArray list;
+    for(auto &r : mResults) {
+        QJsonArray samples;
+        for(auto s : r.samples)
+            samples.append(s);
+        list.append(QJsonObject {
+            { "suite", r.suite },
+            { "name", r.name },
+            { "iterations", r.samples.count() },
+            { "min_us", r.min() },
+            { "median_us", r.median() },
+            { "mean_us", r.mean() },
+            { "max_us", r.max() },
+            { "samples_us", samples }
+        });
+    }
+    QJsonObject root;
+    root.insert("environment", environment);
+    root.insert("results", list);
+    return QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+QByteArray BenchmarkRunner::toCsv() const {
+    QByteArray out;
+    QTextStream stream(&out);
+    stream << "suite,name,iterations,min_us,median_us,mean_us,max_us\n";
+    for(auto &r : mResults) {
+        stream << r.suite << "," << "\"" << QString(r.name).replace("\"", "\"\"") << "\","
+               << r.samples.count() << "," << r.min() << "," << r.median() << ","
+               << r.mean() << "," << r.max() << "\n";
+    }
+    stream.flush();
+    return out;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <QString>
+#include <QVector>
+#include <QRegularExpression>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <functional>
+#include <algorithm>
+
+struct BenchmarkResult {
+    QString suite;
+    QString name;
+    QVector<qint64> samples; // us, sorted
+    qint64 min() const { return samples.isEmpty() ? 0 : samples.first(); }
+    qint64 max() const { return samples.isEmpty() ? 0 : samples.last(); }
+    qint64 median() const { return samples.isEmpty() ? 0 : samples.at(samples.count() / 2); }
+    qint64 mean() const;
+};
+
+// Times callables and collects the results.
+class BenchmarkRunner {
+public:
+    BenchmarkRunner(int _iterations, QString filter);
+
+    // "suite/name" is matched against the filter
+    bool enabled(const QString &suite, const QString &name) const;
+    // One untimed warmup run, then `iterations` timed ones.
+    // setup() runs before each of them and is not timed.
+    void run(const QString &suite, const QString &name,
+             std::function<void()> fn, std::function<void()> setup = nullptr);
+
+    const QVector<BenchmarkResult> &results() const;
+    QByteArray toJson(const QJsonObject &environment) const;
+    QByteArray toCsv() const;
+
+private:
+    int iterations;
+    QRegularExpression filterRegex;
+    QVector<BenchmarkResult> mResults;
+};
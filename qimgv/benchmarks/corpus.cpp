@@ -0,0 +1,190 @@
+#include "corpus.h"
+
+Corpus::Corpus(QString _root) : root(_root) {
+    QDir().mkpath(root);
+}
+
+QList<CorpusImage> Corpus::images(const QList<QSize> &sizes) {
+    QList<QByteArray> formats = { "jpg", "png" };
+    if(QImageWriter::supportedImageFormats().contains("webp"))
+        formats << "webp";
+    else
+        qDebug() << "[Corpus] webp writer not available, skipping";
+    QList<CorpusImage> list;
+    int seed = 0;
+    for(auto &size : sizes) {
+        QImage img;
+        seed++;
+        for(auto &format : formats) {
+            CorpusImage entry;
+            entry.path = root + QString("/image_%1x%2.").arg(size.width()).arg(size.height()) + format;
+            entry.format = format;
+            entry.size = size;
+            if(!QFile::exists(entry.path)) {
+                if(img.isNull())
+                    img = syntheticImage(size, seed);
+                if(!img.save(entry.path, format.constData(), 90)) {
+                    qDebug() << "[Corpus] Could not write" << entry.path;
+                    continue;
+                }
+            }
+            list << entry;
+        }
+    }
+    return list;
+}
+
+CorpusImage Corpus::animation(QSize size, int frameCount) {
+    CorpusImage entry;
+    entry.path = root + QString("/animation_%1x%2_%3.gif").arg(size.width()).arg(size.height()).arg(frameCount);
+    entry.format = "gif";
+    entry.size = size;
+    if(!QFile::exists(entry.path)) {
+        QList<QImage> frames;
+        for(int i = 0; i < frameCount; i++)
+            frames << syntheticImage(size, 1000 + i);
+        if(!writeGif(entry.path, frames, 40))
+            entry.path.clear();
+    }
+    return entry;
+}
+
+QString Corpus::directory(int fileCount) {
+    QString dirPath = root + QString("/dir_%1").arg(fileCount);
+    QDir dir(dirPath);
+    if(dir.exists() && dir.entryList(QDir::Files).count() == fileCount)
+        return dirPath;
+    dir.removeRecursively();
+    QDir().mkpath(dirPath);
+    static const char *extensions[] = { "jpg", "png", "webp", "gif" };
+    quint32 x = 2463534242u;
+    for(int i = 0; i < fileCount; i++) {
+        // scrambled names so sorting has something to do
+        x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+        QString name = QString("img_%1_%2.%3").arg(x % 100000).arg(i).arg(extensions[i % 4]);
+        QFile file(dirPath + "/" + name);
+        if(!file.open(QIODevice::WriteOnly)) {
+            qDebug() << "[Corpus] Could not write" << file.fileName();
+            break;
+        }
+        file.write(QByteArray(static_cast<int>(x % 64), 'x'));
+    }
+    return dirPath;
+}
+
+// Gradients, a few shapes and some noise. Compresses roughly like a photo.
+QImage Corpus::syntheticImage(QSize size, int seed) {
+    QImage img(size, QImage::Format_RGB32);
+    quint32 x = 0x9E3779B9u * static_cast<quint32>(seed + 1);
+    int w = size.width(), h = size.height();
+    int cx = (seed * 7919) % qMax(w, 1), cy = (seed * 104729) % qMax(h, 1);
+    qint64 radius2 = static_cast<qint64>(qMin(w, h) / 3) * (qMin(w, h) / 3);
+    for(int y = 0; y < h; y++) {
+        QRgb *line = reinterpret_cast<QRgb*>(img.scanLine(y));
+        for(int i = 0; i < w; i++) {
+            x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+            int noise = static_cast<int>(x & 15) - 8;
+            int r = 255 * i / qMax(w, 1);
+            int g = 255 * y / qMax(h, 1);
+            int b = (i + y + seed * 31) & 255;
+            qint64 dx = i - cx, dy = y - cy;
+            if(dx * dx + dy * dy < radius2) {
+                r = 255 - r;
+                b = 255 - g;
+            }
+            line[i] = qRgb(qBound(0, r + noise, 255), qBound(0, g + noise, 255), qBound(0, b + noise, 255));
+        }
+    }
+    return img;
+}
+
+// Qt can read gifs but not write them, so here is a minimal writer:
+// 6x6x6 color cube palette and "uncompressed" LZW (only literal codes,
+// with a clear code often enough that the code size stays at 9 bits).
+bool Corpus::writeGif(const QString &path, const QList<QImage> &frames, int delayMs) {
+    if(frames.isEmpty())
+        return false;
+    QFile file(path);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[Corpus] Could not write" << path;
+        return false;
+    }
+    QByteArray out;
+    auto put16 = [&out](int v) {
+        out.append(static_cast<char>(v & 0xFF));
+        out.append(static_cast<char>((v >> 8) & 0xFF));
+    };
+    int w = frames.first().width(), h = frames.first().height();
+    out.append("GIF89a");
+    put16(w);
+    put16(h);
+    out.append(static_cast<char>(0xF7)); // global color table, 256 entries
+    out.append('\0');
+    out.append('\0');
+    for(int i = 0; i < 256; i++) {
+        if(i < 216) {
+            out.append(static_cast<char>((i / 36) * 51));
+            out.append(static_cast<char>((i / 6 % 6) * 51));
+            out.append(static_cast<char>((i % 6) * 51));
+        } else {
+            out.append(3, '\0');
+        }
+    }
+    // loop forever
+    out.append("\x21\xFF\x0B" "NETSCAPE2.0" "\x03\x01\x00\x00\x00", 19);
+
+    for(auto &frame : frames) {
+        QImage img = frame.convertToFormat(QImage::Format_RGB32);
+        // graphic control extension
+        out.append("\x21\xF9\x04\x00", 4);
+        put16(delayMs / 10);
+        out.append('\0');
+        out.append('\0');
+        // image descriptor
+        out.append('\x2C');
+        put16(0);
+        put16(0);
+        put16(w);
+        put16(h);
+        out.append('\0');
+        out.append('\x08'); // lzw minimum code size
+
+        QByteArray data;
+        quint32 bitBuffer = 0;
+        int bitCount = 0;
+        auto putCode = [&](int code) {
+            bitBuffer |= static_cast<quint32>(code) << bitCount;
+            bitCount += 9;
+            while(bitCount >= 8) {
+                data.append(static_cast<char>(bitBuffer & 0xFF));
+                bitBuffer >>= 8;
+                bitCount -= 8;
+            }
+        };
+        const int CLEAR = 256, EOI = 257, RUN = 250;
+        int sinceClear = RUN;
+        for(int y = 0; y < h; y++) {
+            const QRgb *line = reinterpret_cast<const QRgb*>(img.constScanLine(y));
+            for(int x = 0; x < w; x++) {
+                if(sinceClear == RUN) {
+                    putCode(CLEAR);
+                    sinceClear = 0;
+                }
+                QRgb c = line[x];
+                putCode((qRed(c) * 6 / 256) * 36 + (qGreen(c) * 6 / 256) * 6 + (qBlue(c) * 6 / 256));
+                sinceClear++;
+            }
+        }
+        putCode(EOI);
+        if(bitCount > 0)
+            data.append(static_cast<char>(bitBuffer & 0xFF));
+        for(int pos = 0; pos < data.size(); pos += 255) {
+            int len = qMin(255, static_cast<int>(data.size()) - pos);
+            out.append(static_cast<char>(len));
+            out.append(data.constData() + pos, len);
+        }
+        out.append('\0');
+    }
+    out.append('\x3B');
+    return file.write(out) == out.size();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QString>
+#include <QList>
+#include <QSize>
+#include <QImage>
+#include <QImageWriter>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+struct CorpusImage {
+    QString path;
+    QByteArray format;
+    QSize size;
+};
+
+// Generates (or reuses) synthetic test files under a root directory.
+// Files are only written if missing, so a persistent --corpus dir
+// skips the slow part on later runs.
+class Corpus {
+public:
+    explicit Corpus(QString _root);
+
+    // jpg, png and webp (if supported) for every size
+    QList<CorpusImage> images(const QList<QSize> &sizes);
+    // animated gif
+    CorpusImage animation(QSize size, int frameCount);
+    // directory with `fileCount` files with image extensions, tiny contents
+    QString directory(int fileCount);
+
+    static QImage syntheticImage(QSize size, int seed);
+
+private:
+    QString root;
+
+    bool writeGif(const QString &path, const QList<QImage> &frames, int delayMs);
+};
@@ -0,0 +1,230 @@
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QSysInfo>
+#include <QDateTime>
+#include <QFile>
+#include <QTextStream>
+
+#include "appversion.h"
+#include "settings.h"
+#include "utils/imagefactory.h"
+#include "utils/imagelib.h"
+#include "components/cache/thumbnailcache.h"
+#include "components/thumbnailer/thumbnailerrunnable.h"
+#include "components/directorymanager/directorymanager.h"
+#include "benchmarkrunner.h"
+#include "corpus.h"
+
+// Headless benchmarks for the load / scale / thumbnail / directory pipelines.
+// Results go to stdout (or --output) as JSON or CSV; progress goes to stderr.
+
+static QString sizeName(QSize size) {
+    return QString("%1x%2").arg(size.width()).arg(size.height());
+}
+
+static QString filterName(ScalingFilter filter) {
+    switch(filter) {
+    case QI_FILTER_NEAREST: return "nearest";
+    case QI_FILTER_BILINEAR: return "bilinear";
+    case QI_FILTER_CV_BILINEAR_SHARPEN: return "cv_bilinear_sharpen";
+    case QI_FILTER_CV_CUBIC: return "cv_cubic";
+    case QI_FILTER_CV_CUBIC_SHARPEN: return "cv_cubic_sharpen";
+    }
+    return "unknown";
+}
+
+static void benchDecode(BenchmarkRunner &runner, const QList<CorpusImage> &images) {
+    for(auto &entry : images) {
+        runner.run("decode", entry.format + " " + sizeName(entry.size), [&]() {
+            auto img = ImageFactory::createImage(entry.path);
+            if(!img)
+                qDebug() << "[decode] failed:" << entry.path;
+        });
+    }
+}
+
+static void benchScale(BenchmarkRunner &runner, const QList<QSize> &sizes) {
+    QList<ScalingFilter> filters = { QI_FILTER_NEAREST, QI_FILTER_BILINEAR, QI_FILTER_CV_BILINEAR_SHARPEN,
+                                     QI_FILTER_CV_CUBIC, QI_FILTER_CV_CUBIC_SHARPEN };
+    for(auto &size : sizes) {
+        std::shared_ptr<const QImage> source(new QImage(Corpus::syntheticImage(size, 1)));
+        // typical window fit (downscale) and a zoom in (upscale)
+        QList<QSize> targets = { size.scaled(1280, 720, Qt::KeepAspectRatio), size * 1.5 };
+        for(auto filter : filters) {
+            for(auto &target : targets) {
+                runner.run("scale", sizeName(size) + " -> " + sizeName(target) + " " + filterName(filter), [&]() {
+                    delete ImageLib::scaled(source, target, filter);
+                });
+            }
+        }
+    }
+}
+
+static void benchThumbnails(BenchmarkRunner &runner, const QList<CorpusImage> &images, int thumbnailSize) {
+    ThumbnailCache cache;
+    auto clearCache = []() {
+        QDir dir(settings->thumbnailCacheDir());
+        dir.removeRecursively();
+        dir.mkpath(dir.absolutePath());
+    };
+    for(auto &entry : images) {
+        QString name = entry.format + " " + sizeName(entry.size);
+        runner.run("thumbnail_cold", name, [&]() {
+            ThumbnailerRunnable::generate(&cache, entry.path, thumbnailSize, false, false);
+        }, clearCache);
+        // filled by the warmup run
+        runner.run("thumbnail_warm", name, [&]() {
+            ThumbnailerRunnable::generate(&cache, entry.path, thumbnailSize, false, false);
+        });
+    }
+    clearCache();
+}
+
+static void benchDirectories(BenchmarkRunner &runner, Corpus &corpus, const QList<int> &fileCounts) {
+    QList<QPair<SortingMode, QString>> modes = {
+        { SORT_NAME, "name" }, { SORT_NAME_DESC, "name_desc" },
+        { SORT_SIZE, "size" }, { SORT_SIZE_DESC, "size_desc" },
+        { SORT_TIME, "time" }, { SORT_TIME_DESC, "time_desc" }
+    };
+    for(auto count : fileCounts) {
+        QString name = QString::number(count) + " files";
+        if(!runner.enabled("directory", name + " open") && !runner.enabled("directory", name + " sort"))
+            continue;
+        QString dirPath = corpus.directory(count);
+        // measure the actual scan, not a listing snapshot left by the warmup
+        settings->setListingSnapshots(false);
+        DirectoryManager manager;
+        runner.run("directory", name + " open", [&]() {
+            manager.setDirectory(dirPath);
+        });
+        for(auto &mode : modes) {
+            // alternate so every run actually reorders the list
+            runner.run("directory", name + " sort " + mode.second, [&]() {
+                manager.setSortingMode(mode.first);
+            }, [&]() {
+                manager.setSortingMode(mode.first == SORT_NAME ? SORT_NAME_DESC : SORT_NAME);
+            });
+        }
+    }
+}
+
+static QStringList splitList(const QString &str) {
+#if QT_VERSION < QT_VERSION_CHECK(5, 14, 0)
+    return str.split(",", QString::SkipEmptyParts);
+#else
+    return str.split(",", Qt::SkipEmptyParts);
+#endif
+}
+
+static QList<int> parseIntList(const QString &str) {
+    QList<int> list;
+    for(auto &part : splitList(str))
+        list << part.trimmed().toInt();
+    return list;
+}
+
+static QList<QSize> parseSizeList(const QString &str) {
+    QList<QSize> list;
+    for(auto &part : splitList(str)) {
+        auto wh = part.trimmed().split("x");
+        if(wh.count() == 2)
+            list << QSize(wh.at(0).toInt(), wh.at(1).toInt());
+    }
+    return list;
+}
+
+int main(int argc, char *argv[]) {
+    // pixmaps need a gui application, but no display
+    if(qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication a(argc, argv);
+    QCoreApplication::setOrganizationName("qimgv");
+    QCoreApplication::setApplicationName("qimgv-benchmarks");
+    QCoreApplication::setApplicationVersion(appVersion.toString());
+    // keep away from the user's config and thumbnail cache
+    QStandardPaths::setTestModeEnabled(true);
+
+    qRegisterMetaType<std::shared_ptr<Image>>("std::shared_ptr<Image>");
+    qRegisterMetaType<std::shared_ptr<Thumbnail>>("std::shared_ptr<Thumbnail>");
+    qRegisterMetaType<std::shared_ptr<ListingSnapshot>>("std::shared_ptr<ListingSnapshot>");
+    qRegisterMetaType<QVector<MetadataResult>>("QVector<MetadataResult>");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("qimgv benchmarks");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"corpus", "Directory for the generated test files. Reused between runs. A temporary one is used if not set.", "dir"},
+        {"iterations", "Timed runs per case (default 5).", "n"},
+        {"filter", "Only run cases where \"suite/name\" matches this regex.", "regex"},
+        {"sizes", "Image sizes (default 1920x1080,3840x2160,7680x4320).", "list"},
+        {"files", "Directory sizes (default 10000,50000,200000).", "list"},
+        {"thumbnail-size", "Thumbnail size (default 256).", "px"},
+        {"format", "json (default) or csv.", "format"},
+        {"output", "Write results to a file instead of stdout.", "file"},
+    });
+    parser.process(a);
+
+    int iterations = parser.isSet("iterations") ? parser.value("iterations").toInt() : 5;
+    QList<QSize> sizes = parseSizeList(parser.isSet("sizes") ? parser.value("sizes") : "1920x1080,3840x2160,7680x4320");
+    QList<int> fileCounts = parseIntList(parser.isSet("files") ? parser.value("files") : "10000,50000,200000");
+    int thumbnailSize = parser.isSet("thumbnail-size") ? parser.value("thumbnail-size").toInt() : 256;
+
+    QTemporaryDir tmpDir;
+    QString corpusPath = parser.isSet("corpus") ? parser.value("corpus") : tmpDir.path();
+    if(corpusPath.isEmpty()) {
+        QTextStream(stderr) << "Could not create a temporary directory; use --corpus\n";
+        return 1;
+    }
+
+    settings = Settings::getInstance();
+    BenchmarkRunner runner(iterations, parser.value("filter"));
+    Corpus corpus(corpusPath);
+
+    QTextStream(stderr) << "Generating corpus in " << corpusPath << "\n";
+    QList<CorpusImage> images = corpus.images(sizes);
+    QList<CorpusImage> withAnimation = images;
+    auto animation = corpus.animation(QSize(480, 270), 60);
+    if(!animation.path.isEmpty())
+        withAnimation << animation;
+
+    benchDecode(runner, withAnimation);
+    benchScale(runner, sizes);
+    benchThumbnails(runner, withAnimation, thumbnailSize);
+    benchDirectories(runner, corpus, fileCounts);
+
+    QByteArray out;
+    if(parser.value("format") == "csv") {
+        out = runner.toCsv();
+    } else {
+        QJsonObject environment {
+            { "version", appVersion.toString() },
+            { "qt", qVersion() },
+            { "cpu", QSysInfo::currentCpuArchitecture() },
+            { "os", QSysInfo::prettyProductName() },
+            { "threads", QThread::idealThreadCount() },
+            { "date", QDateTime::currentDateTimeUtc().toString(Qt::ISODate) },
+#ifdef USE_OPENCV
+            { "opencv", true },
+#else
+            { "opencv", false },
+#endif
+            { "iterations", iterations }
+        };
+        out = runner.toJson(environment);
+    }
+    if(parser.isSet("output")) {
+        QFile file(parser.value("output"));
+        if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            QTextStream(stderr) << "Could not write " << file.fileName() << "\n";
+            return 1;
+        }
+        file.write(out);
+    } else {
+        QFile stdoutFile;
+        stdoutFile.open(stdout, QIODevice::WriteOnly);
+        stdoutFile.write(out);
+    }
+    return 0;
+}
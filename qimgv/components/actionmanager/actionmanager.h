@@ -123,6 +123,8 @@ signals:
     void print();
     void toggleFullscreenInfoBar();
     void pasteFile();
+    void cancelFileOperations();
+    void togglePerfOverlay();
 };
 
 extern ActionManager *actionManager;
@@ -0,0 +1,269 @@
+#include "animationdecoder.h"
+
+// Reads the first frame right away (on the caller's thread) so the size and
+// frame count are known. The worker only starts with the first takeFrame().
+AnimationDecoder::AnimationDecoder(QString _path, QByteArray _format)
+    : path(_path),
+      format(_format),
+      mFrameCount(0),
+      ringCapacity(MIN_RING_FRAMES),
+      keyframeInterval(1),
+      knownDelays(0),
+      mDuration(-1),
+      target(0),
+      requested(-1),
+      abort(false),
+      suspended(false),
+      readFailed(false)
+{
+    QImageReader reader;
+    open(reader);
+    mFrameCount = reader.imageCount();
+    if(!decodeFrame(reader, 0, mFirstFrame)) {
+        qDebug() << "[AnimationDecoder] Could not read" << path << reader.errorString();
+        return;
+    }
+    mSize = mFirstFrame.image.size();
+    if(mFrameCount < 1)
+        mFrameCount = 1;
+    qint64 frameBytes = qMax<qint64>(static_cast<qint64>(mFirstFrame.image.bytesPerLine()) * mFirstFrame.image.height(), 1);
+    ringCapacity = static_cast<int>(qBound<qint64>(MIN_RING_FRAMES, RING_BUDGET / frameBytes, MAX_RING_FRAMES));
+    ringCapacity = qMin(ringCapacity, mFrameCount);
+    keyframeInterval = static_cast<int>(mFrameCount * frameBytes / KEYFRAME_BUDGET + 1);
+    keyframes.insert(0, mFirstFrame);
+    mCurrentFrame = mFirstFrame;
+    delays.fill(-1, mFrameCount);
+    recordDelay(mFirstFrame);
+}
+
+AnimationDecoder::~AnimationDecoder() {
+    mutex.lock();
+    abort = true;
+    wakeup.wakeAll();
+    mutex.unlock();
+    wait();
+}
+
+bool AnimationDecoder::isValid() const {
+    return !mFirstFrame.image.isNull();
+}
+
+// can shrink during playback if a frame turns out to be unreadable
+int AnimationDecoder::frameCount() {
+    QMutexLocker lock(&mutex);
+    return mFrameCount;
+}
+
+QSize AnimationDecoder::size() const {
+    return mSize;
+}
+
+AnimationFrame AnimationDecoder::firstFrame() const {
+    return mFirstFrame;
+}
+
+AnimationFrame AnimationDecoder::currentFrame() {
+    QMutexLocker lock(&mutex);
+    return mCurrentFrame;
+}
+
+int AnimationDecoder::duration() {
+    QMutexLocker lock(&mutex);
+    return mDuration;
+}
+
+bool AnimationDecoder::takeFrame(int index, AnimationFrame &frame) {
+    if(!isValid() || index < 0)
+        return false;
+    QMutexLocker lock(&mutex);
+    // frames past a broken one are served as the last readable frame
+    int wanted = qMin(index, mFrameCount - 1);
+    target = wanted;
+    suspended = false;
+    bool found = false;
+    for(auto &f : ring) {
+        if(f.index == wanted) {
+            frame = f;
+            found = true;
+            break;
+        }
+    }
+    if(!found && keyframes.contains(wanted)) {
+        frame = keyframes.value(wanted);
+        found = true;
+    }
+    requested = found ? -1 : index;
+    if(found)
+        mCurrentFrame = frame;
+    trimRing();
+    if(!isRunning())
+        start(QThread::LowPriority);
+    wakeup.wakeOne();
+    return found;
+}
+
+bool AnimationDecoder::nearestKeyframe(int index, AnimationFrame &frame) {
+    QMutexLocker lock(&mutex);
+    auto it = keyframes.upperBound(index);
+    if(it == keyframes.begin())
+        return false;
+    frame = *(--it);
+    return true;
+}
+
+void AnimationDecoder::suspend() {
+    QMutexLocker lock(&mutex);
+    suspended = true;
+    requested = -1;
+    ring.clear();
+    keyframes.clear();
+    keyframes.insert(0, mFirstFrame);
+    mCurrentFrame = mFirstFrame;
+}
+
+void AnimationDecoder::run() {
+    QImageReader reader;
+    open(reader);
+    int readerPos = 0; // index of the frame the next read() returns
+    forever {
+        mutex.lock();
+        while(!abort && (suspended || windowFilled(readerPos)))
+            wakeup.wait(&mutex);
+        if(abort) {
+            mutex.unlock();
+            return;
+        }
+        // seek backwards: start over
+        bool restart = (readerPos >= mFrameCount) || (!ringContains(target) && target < readerPos);
+        mutex.unlock();
+
+        if(restart) {
+            open(reader);
+            readerPos = 0;
+        }
+        AnimationFrame frame;
+        bool ok = decodeFrame(reader, readerPos, frame);
+
+        QMutexLocker lock(&mutex);
+        if(abort)
+            return;
+        if(!ok) {
+            if(!readFailed) {
+                qDebug() << "[AnimationDecoder] Could not read frame" << readerPos << reader.errorString();
+                readFailed = true;
+            }
+            if(readerPos == 0) {
+                // the file itself is gone; park until someone asks for a frame again
+                suspended = true;
+                continue;
+            }
+            // The reader can't get past a broken frame, so the animation
+            // ends at the last good one. Reaching the new end restarts the
+            // reader as usual, and the broken frame is never read again.
+            truncate(readerPos);
+            if(requested != -1 && requested >= mFrameCount && ringContains(mFrameCount - 1)) {
+                int index = requested;
+                requested = -1;
+                emit frameReady(index);
+            }
+            continue;
+        }
+        readerPos++;
+        recordDelay(frame);
+        if(suspended)
+            continue;
+        if(frame.index % keyframeInterval == 0)
+            keyframes.insert(frame.index, frame);
+        bool inWindow = distance(target, frame.index) < ringCapacity || distance(frame.index, target) <= KEEP_BEHIND;
+        if(inWindow && !ringContains(frame.index)) {
+            ring.append(frame);
+            if(requested != -1 && frame.index == qMin(requested, mFrameCount - 1)) {
+                int index = requested;
+                requested = -1;
+                emit frameReady(index);
+            }
+        }
+    }
+}
+
+void AnimationDecoder::open(QImageReader &reader) {
+    reader.setFileName(path);
+    reader.setFormat(format);
+}
+
+bool AnimationDecoder::decodeFrame(QImageReader &reader, int index, AnimationFrame &frame) {
+    QImage img = reader.read();
+    if(img.isNull())
+        return false;
+    frame.index = index;
+    frame.delay = qMax(reader.nextImageDelay(), 0);
+    // convert here instead of inside QPixmap::fromImage() on the gui thread
+    if(img.hasAlphaChannel())
+        frame.image = img.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    else
+        frame.image = img.convertToFormat(QImage::Format_RGB32);
+    return true;
+}
+
+// how many frames forward from -> to, wrapping around the loop
+int AnimationDecoder::distance(int from, int to) const {
+    return ((to - from) % mFrameCount + mFrameCount) % mFrameCount;
+}
+
+bool AnimationDecoder::ringContains(int index) const {
+    for(auto &f : ring)
+        if(f.index == index)
+            return true;
+    return false;
+}
+
+// Frames are decoded in order, so if the target frame is present then
+// everything between it and the reader is too.
+bool AnimationDecoder::windowFilled(int readerPos) const {
+    if(!ringContains(target))
+        return false;
+    int d = distance(target, readerPos % mFrameCount);
+    return (d == 0 || d >= ringCapacity);
+}
+
+void AnimationDecoder::trimRing() {
+    for(int i = ring.count() - 1; i >= 0; i--) {
+        int idx = ring.at(i).index;
+        if(distance(target, idx) >= ringCapacity && distance(idx, target) > KEEP_BEHIND)
+            ring.removeAt(i);
+    }
+}
+
+void AnimationDecoder::recordDelay(const AnimationFrame &frame) {
+    if(frame.index >= delays.count() || delays.at(frame.index) != -1)
+        return;
+    delays[frame.index] = frame.delay;
+    knownDelays++;
+    updateDuration();
+}
+
+void AnimationDecoder::updateDuration() {
+    if(knownDelays != delays.count())
+        return;
+    mDuration = 0;
+    for(auto delay : delays)
+        mDuration += delay;
+}
+
+// drops everything from frame `count` onward
+void AnimationDecoder::truncate(int count) {
+    if(count >= mFrameCount)
+        return;
+    mFrameCount = count;
+    ringCapacity = qMin(ringCapacity, mFrameCount);
+    while(keyframes.lastKey() >= mFrameCount)
+        keyframes.remove(keyframes.lastKey());
+    for(int i = ring.count() - 1; i >= 0; i--)
+        if(ring.at(i).index >= mFrameCount)
+            ring.removeAt(i);
+    if(target >= mFrameCount)
+        target = mFrameCount - 1;
+    delays.resize(mFrameCount);
+    knownDelays = static_cast<int>(delays.count() - delays.count(-1));
+    updateDuration();
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QImageReader>
+#include <QImage>
+#include <QList>
+#include <QMap>
+#include <QVector>
+#include <QDebug>
+
+struct AnimationFrame {
+    int index = -1;
+    int delay = 0; // ms to wait before the next frame
+    QImage image;
+};
+
+// Decodes animation frames ahead of the playback position on its own thread.
+//
+// Decoded frames go into a small ring around the current position, sized
+// by RING_BUDGET. Every keyframeInterval-th frame is also kept as a
+// snapshot (bounded by KEYFRAME_BUDGET), so seeking to it is instant.
+// Seeking anywhere else shows the nearest snapshot until the exact frame
+// arrives via frameReady().
+//
+// QImageReader can only decode forward, so a backwards seek to a frame that
+// is not in the ring restarts the reader. That happens on the worker thread.
+class AnimationDecoder : public QThread {
+    Q_OBJECT
+public:
+    AnimationDecoder(QString _path, QByteArray _format);
+    ~AnimationDecoder();
+
+    bool isValid() const;
+    int frameCount();
+    QSize size() const;
+    AnimationFrame firstFrame() const;
+    // last frame handed out by takeFrame()
+    AnimationFrame currentFrame();
+    // total loop length in ms; -1 until every frame has been decoded once
+    int duration();
+
+    // Non-blocking. Returns false if the frame is not decoded yet; the
+    // decoder then seeks there and emits frameReady(index) when it's done.
+    // Also moves the ring forward, so call it in playback order.
+    bool takeFrame(int index, AnimationFrame &frame);
+    // closest snapshot at or before index, for use while seeking
+    bool nearestKeyframe(int index, AnimationFrame &frame);
+    // drop decoded frames and park the worker until the next takeFrame()
+    void suspend();
+
+signals:
+    void frameReady(int index);
+
+protected:
+    void run() override;
+
+private:
+    QString path;
+    QByteArray format;
+    int mFrameCount;
+    QSize mSize;
+    AnimationFrame mFirstFrame;
+    int ringCapacity, keyframeInterval;
+
+    // shared with the worker, guarded by mutex
+    QMutex mutex;
+    QWaitCondition wakeup;
+    QList<AnimationFrame> ring;
+    QMap<int, AnimationFrame> keyframes;
+    AnimationFrame mCurrentFrame;
+    QVector<int> delays;
+    int knownDelays, mDuration;
+    int target, requested;
+    bool abort, suspended, readFailed;
+
+    const qint64 RING_BUDGET = 96 * 1024 * 1024;
+    const qint64 KEYFRAME_BUDGET = 64 * 1024 * 1024;
+    const int MIN_RING_FRAMES = 3;
+    const int MAX_RING_FRAMES = 12;
+    const int KEEP_BEHIND = 2;
+
+    void open(QImageReader &reader);
+    bool decodeFrame(QImageReader &reader, int index, AnimationFrame &frame);
+    int distance(int from, int to) const;
+    bool ringContains(int index) const;
+    bool windowFilled(int readerPos) const;
+    void trimRing();
+    void recordDelay(const AnimationFrame &frame);
+    void updateDuration();
+    void truncate(int count);
+};
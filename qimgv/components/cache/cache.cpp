@@ -4,15 +4,17 @@ Cache::Cache() {
 }
 
 bool Cache::contains(QString path) const {
+    QReadLocker locker(&lock);
     return items.contains(path);
 }
 
 bool Cache::insert(std::shared_ptr<Image> img) {
     if(img) {
+        QWriteLocker locker(&lock);
         if(items.contains(img->filePath())) {
             return false;
         } else {
-            items.insert(img->filePath(), new CacheItem(img));
+            items.insert(img->filePath(), img);
             return true;
         }
     }
@@ -20,57 +22,43 @@ bool Cache::insert(std::shared_ptr<Image> img) {
     return true;
 }
 
+// Removed images are released after unlocking; if this was the
+// last reference the destructor may take a while.
 void Cache::remove(QString path) {
-    if(items.contains(path)) {
-        items[path]->lock();
-        auto *item = items.take(path);
-        delete item;
-    }
+    std::shared_ptr<Image> removed;
+    QWriteLocker locker(&lock);
+    removed = items.take(path);
+    locker.unlock();
 }
 
 void Cache::clear() {
-    for(auto path : items.keys()) {
-        items[path]->lock();
-        auto item = items.take(path);
-        delete item;
-    }
-}
-
-std::shared_ptr<Image> Cache::get(QString path) {
-    if(items.contains(path)) {
-        CacheItem *item = items.value(path);
-        return item->getContents();
-    }
-    return nullptr;
+    QHash<QString, std::shared_ptr<Image>> removed;
+    QWriteLocker locker(&lock);
+    removed.swap(items);
+    locker.unlock();
 }
 
-bool Cache::reserve(QString path) {
-    if(items.contains(path)) {
-        items[path]->lock();
-        return true;
-    }
-    return false;
-}
-
-bool Cache::release(QString path) {
-    if(items.contains(path)) {
-        items[path]->unlock();
-        return true;
-    }
-    return false;
+std::shared_ptr<Image> Cache::get(QString path) const {
+    QReadLocker locker(&lock);
+    return items.value(path);
 }
 
 // removes all items except the ones in list
 void Cache::trimTo(QStringList pathList) {
-    for(auto path : items.keys()) {
-        if(!pathList.contains(path)) {
-            items[path]->lock();
-            auto *item = items.take(path);
-            delete item;
+    std::vector<std::shared_ptr<Image>> removed;
+    QWriteLocker locker(&lock);
+    for(auto it = items.begin(); it != items.end();) {
+        if(!pathList.contains(it.key())) {
+            removed.push_back(it.value());
+            it = items.erase(it);
+        } else {
+            ++it;
         }
     }
+    locker.unlock();
 }
 
 const QList<QString> Cache::keys() const {
+    QReadLocker locker(&lock);
     return items.keys();
 }
@@ -1,13 +1,18 @@
 #pragma once
 
 #include <QDebug>
-#include <QMap>
-#include <QSemaphore>
-#include <QMutexLocker>
+#include <QHash>
+#include <QReadWriteLock>
+#include <vector>
 #include "sourcecontainers/image.h"
-#include "components/cache/cacheitem.h"
 #include "utils/imagefactory.h"
 
+// Decoded images by path.
+//
+// Entries are plain shared_ptr references: whoever still works on an image
+// (the scaler, mostly) holds its own copy, so removing an entry never
+// has to wait for anyone. The image is freed when the last copy goes away.
+// Safe to use from any thread.
 class Cache {
 public:
     explicit Cache();
@@ -18,11 +23,10 @@ public:
     bool insert(std::shared_ptr<Image> img);
     void trimTo(QStringList list);
 
-    std::shared_ptr<Image> get(QString path);
-    bool release(QString path);
-    bool reserve(QString path);
+    std::shared_ptr<Image> get(QString path) const;
     const QList<QString> keys() const;
 
 private:
-    QMap<QString, CacheItem*> items;
+    QHash<QString, std::shared_ptr<Image>> items;
+    mutable QReadWriteLock lock;
 };
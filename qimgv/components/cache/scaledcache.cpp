@@ -0,0 +1,86 @@
+#include "scaledcache.h"
+
+static qint64 imageBytes(const QImage &image) {
+    return static_cast<qint64>(image.bytesPerLine()) * image.height();
+}
+
+ScaledCache::ScaledCache() : usedBytes(0) {
+}
+
+bool ScaledCache::get(const ScalerRequest &req, QImage &scaled) {
+    QMutexLocker locker(&mutex);
+    int index = indexOf(req);
+    if(index == -1)
+        return false;
+    if(index != 0)
+        entries.move(index, 0);
+    scaled = entries.first().scaled;
+    return true;
+}
+
+bool ScaledCache::contains(const ScalerRequest &req) {
+    QMutexLocker locker(&mutex);
+    return indexOf(req) != -1;
+}
+
+void ScaledCache::insert(const ScalerRequest &req, const QImage &scaled) {
+    if(!req.image || scaled.isNull())
+        return;
+    qint64 bytes = imageBytes(scaled);
+    // don't let one huge result push out everything else
+    if(bytes > BUDGET / 2)
+        return;
+    QMutexLocker locker(&mutex);
+    int index = indexOf(req);
+    if(index != -1)
+        removeAt(index);
+    Entry entry;
+    entry.image = req.image;
+    entry.path = req.image->filePath();
+    entry.size = req.size;
+    entry.filter = req.filter;
+    entry.scaled = scaled;
+    entries.prepend(entry);
+    usedBytes += bytes;
+    while(usedBytes > BUDGET && !entries.isEmpty())
+        removeAt(entries.count() - 1);
+}
+
+void ScaledCache::remove(QString path) {
+    QMutexLocker locker(&mutex);
+    for(int i = entries.count() - 1; i >= 0; i--) {
+        if(entries.at(i).path == path)
+            removeAt(i);
+    }
+}
+
+// removes all entries except the ones for paths in list
+void ScaledCache::trimTo(QStringList pathList) {
+    QMutexLocker locker(&mutex);
+    for(int i = entries.count() - 1; i >= 0; i--) {
+        if(!pathList.contains(entries.at(i).path))
+            removeAt(i);
+    }
+}
+
+void ScaledCache::clear() {
+    QMutexLocker locker(&mutex);
+    entries.clear();
+    usedBytes = 0;
+}
+
+int ScaledCache::indexOf(const ScalerRequest &req) const {
+    if(!req.image)
+        return -1;
+    for(int i = 0; i < entries.count(); i++) {
+        auto &entry = entries.at(i);
+        if(entry.size == req.size && entry.filter == req.filter && entry.image.lock() == req.image)
+            return i;
+    }
+    return -1;
+}
+
+void ScaledCache::removeAt(int index) {
+    usedBytes -= imageBytes(entries.at(index).scaled);
+    entries.removeAt(index);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QImage>
+#include <QMutex>
+#include <QList>
+#include <QStringList>
+#include <memory>
+#include "components/scaler/scalerrequest.h"
+
+// Recent scaler results, so switching fit modes or going back to an image
+// doesn't scale it again. Entries are matched by image object (not just path),
+// size and filter. Least recently used ones go first once over budget.
+class ScaledCache {
+public:
+    explicit ScaledCache();
+
+    bool get(const ScalerRequest &req, QImage &scaled);
+    bool contains(const ScalerRequest &req);
+    void insert(const ScalerRequest &req, const QImage &scaled);
+    void remove(QString path);
+    void trimTo(QStringList pathList);
+    void clear();
+
+private:
+    struct Entry {
+        std::weak_ptr<Image> image;
+        QString path;
+        QSize size;
+        ScalingFilter filter;
+        QImage scaled;
+    };
+    QList<Entry> entries; // most recently used first
+    qint64 usedBytes;
+    QMutex mutex;
+
+    const qint64 BUDGET = 128 * 1024 * 1024;
+
+    int indexOf(const ScalerRequest &req) const;
+    void removeAt(int index);
+};
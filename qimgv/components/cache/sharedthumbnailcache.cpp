@@ -0,0 +1,92 @@
+#include "sharedthumbnailcache.h"
+
+SharedThumbnailCache::SharedThumbnailCache() {
+    QString cacheHome = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if(cacheHome.isEmpty())
+        cacheHome = QDir::homePath() + "/.cache";
+    rootPath = cacheHome + "/thumbnails/";
+}
+
+int SharedThumbnailCache::bucketSize(int size) {
+    for(int bucket : { 128, 256, 512, 1024 })
+        if(size <= bucket)
+            return bucket;
+    return 0;
+}
+
+QString SharedThumbnailCache::bucketName(int bucket) {
+    switch(bucket) {
+        case 128:  return "normal";
+        case 256:  return "large";
+        case 512:  return "x-large";
+        case 1024: return "xx-large";
+        default:   return "";
+    }
+}
+
+// the standard wants it escaped as per rfc 2396, same as glib does
+QString SharedThumbnailCache::fileUri(const QString &filePath) {
+    return QString::fromLatin1(QUrl::fromLocalFile(QFileInfo(filePath).absoluteFilePath()).toEncoded());
+}
+
+QString SharedThumbnailCache::thumbnailPath(const QString &uri, int bucket) const {
+    QString id = QCryptographicHash::hash(uri.toUtf8(), QCryptographicHash::Md5).toHex();
+    return rootPath + bucketName(bucket) + "/" + id + ".png";
+}
+
+bool SharedThumbnailCache::accepts(const QString &filePath) const {
+    return !QFileInfo(filePath).absoluteFilePath().startsWith(rootPath);
+}
+
+QImage *SharedThumbnailCache::read(const QString &filePath, qint64 mtime, int bucket) const {
+    if(bucketName(bucket).isEmpty())
+        return nullptr;
+    QString uri = fileUri(filePath);
+    QImageReader reader(thumbnailPath(uri, bucket), "png");
+    // text chunks come with the header; no need to decode a stale one
+    if(!reader.canRead() ||
+       reader.text("Thumb::MTime").toLongLong() != mtime ||
+       reader.text("Thumb::URI") != uri)
+    {
+        return nullptr;
+    }
+    QImage *thumb = new QImage();
+    if(!reader.read(thumb) || thumb->width() > bucket || thumb->height() > bucket) {
+        delete thumb;
+        return nullptr;
+    }
+    return thumb;
+}
+
+void SharedThumbnailCache::write(const QImage &image, const QString &filePath, qint64 mtime, qint64 fileSize, QSize originalSize) const {
+    int bucket = bucketSize(qMax(image.width(), image.height()));
+    if(!bucket)
+        return;
+    QString uri = fileUri(filePath);
+    QString path = thumbnailPath(uri, bucket);
+    QDir dir(QFileInfo(path).absolutePath());
+    if(!dir.exists()) {
+        dir.mkpath(".");
+        QFile::setPermissions(dir.absolutePath(), QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+    }
+    // written to a temporary file and renamed, so nobody reads half of it
+    QSaveFile file(path);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[SharedThumbnailCache] could not write" << path;
+        return;
+    }
+    QImageWriter writer(&file, "png");
+    writer.setText("Thumb::URI", uri);
+    writer.setText("Thumb::MTime", QString::number(mtime));
+    writer.setText("Thumb::Size", QString::number(fileSize));
+    if(originalSize.isValid()) {
+        writer.setText("Thumb::Image::Width", QString::number(originalSize.width()));
+        writer.setText("Thumb::Image::Height", QString::number(originalSize.height()));
+    }
+    writer.setText("Software", "qimgv");
+    if(!writer.write(image) || !file.commit()) {
+        qDebug() << "[SharedThumbnailCache] could not write" << path;
+        return;
+    }
+    QFile::setPermissions(path, QFile::ReadOwner | QFile::WriteOwner);
+}
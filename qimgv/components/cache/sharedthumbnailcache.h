@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QDir>
+#include <QUrl>
+#include <QImage>
+#include <QImageReader>
+#include <QImageWriter>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include <QDebug>
+
+// Thumbnails shared with file managers and other viewers, as described in
+// the freedesktop.org Thumbnail Managing Standard:
+//   $XDG_CACHE_HOME/thumbnails/{normal,large,x-large,xx-large}/<md5 of file uri>.png
+// Thumbnails there fit into a square of the bucket size, are never cropped,
+// already have exif orientation applied, and carry the source mtime
+// they were made from. Safe to use from any thread.
+class SharedThumbnailCache {
+public:
+    SharedThumbnailCache();
+
+    // smallest bucket a thumbnail of this size can be taken from; 0 if none
+    static int bucketSize(int size);
+    // false for files it makes no sense to thumbnail this way (thumbnails themselves)
+    bool accepts(const QString &filePath) const;
+    // nullptr if there is none, or it was made from another version of the file
+    QImage *read(const QString &filePath, qint64 mtime, int bucket) const;
+    // bucket is taken from the image size
+    void write(const QImage &image, const QString &filePath, qint64 mtime, qint64 fileSize, QSize originalSize) const;
+
+private:
+    static QString bucketName(int bucket);
+    static QString fileUri(const QString &filePath);
+    QString thumbnailPath(const QString &uri, int bucket) const;
+    QString rootPath;
+};
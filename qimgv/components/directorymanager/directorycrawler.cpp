@@ -0,0 +1,158 @@
+#include "directorycrawler.h"
+#include <QFile>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#else
+#include <QFileInfo>
+#endif
+
+namespace fs = std::filesystem;
+
+// i/o bound; most of the time is spent waiting for the disk or the server
+#define CRAWLER_THREADS 8
+
+class CrawlTask : public QRunnable {
+public:
+    CrawlTask(DirectoryCrawler *_crawler, QString _dirPath, int _depth)
+        : crawler(_crawler), dirPath(_dirPath), depth(_depth) { }
+    void run() { crawler->readDirectory(dirPath, depth); }
+
+private:
+    DirectoryCrawler *crawler;
+    QString dirPath;
+    int depth;
+};
+
+DirectoryCrawler::DirectoryCrawler(QRegularExpression _regex)
+    : regex(_regex),
+      maxDepth(-1),
+      followSymlinks(false)
+{
+    pool.setMaxThreadCount(CRAWLER_THREADS);
+}
+
+DirectoryCrawler::~DirectoryCrawler() {
+    pool.waitForDone();
+}
+
+void DirectoryCrawler::setMaxDepth(int depth) {
+    maxDepth = depth;
+}
+
+void DirectoryCrawler::setExcludePatterns(QStringList patterns) {
+    excludes.clear();
+    for(auto &pattern : patterns) {
+        if(pattern.isEmpty())
+            continue;
+        QRegularExpression re(QRegularExpression::wildcardToRegularExpression(pattern));
+        if(re.isValid())
+            excludes.append(re);
+        else
+            qDebug() << "[DirectoryCrawler] invalid exclude pattern:" << pattern;
+    }
+}
+
+void DirectoryCrawler::setFollowSymlinks(bool mode) {
+    followSymlinks = mode;
+}
+
+void DirectoryCrawler::setThreadCount(int count) {
+    pool.setMaxThreadCount(qMax(1, count));
+}
+
+std::vector<FSEntry> DirectoryCrawler::crawl(QString rootPath) {
+    std::vector<FSEntry> result;
+    crawl(rootPath, [&result](std::vector<FSEntry> &batch) {
+        result.insert(result.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+    });
+    return result;
+}
+
+void DirectoryCrawler::crawl(QString _rootPath, std::function<void(std::vector<FSEntry> &)> onBatch) {
+    rootPath = _rootPath;
+    batchHandler = onBatch;
+    visited.clear();
+    if(!markVisited(rootPath))
+        return;
+    // subdirectories are queued by the tasks themselves, before they finish;
+    // so the pool only runs dry once the whole tree is done
+    pool.start(new CrawlTask(this, rootPath, 0));
+    pool.waitForDone();
+    batchHandler = nullptr;
+}
+
+void DirectoryCrawler::readDirectory(QString dirPath, int depth) {
+    std::vector<FSEntry> files;
+    std::error_code ec;
+    fs::directory_iterator it(toStdString(dirPath), fs::directory_options::skip_permission_denied, ec);
+    if(ec) {
+        qDebug() << "[DirectoryCrawler]" << dirPath << QString::fromStdString(ec.message());
+        return;
+    }
+    for(; it != fs::directory_iterator(); it.increment(ec)) {
+        if(ec) {
+            qDebug() << "[DirectoryCrawler]" << dirPath << QString::fromStdString(ec.message());
+            break;
+        }
+        const auto &entry = *it;
+        QString name = QString::fromStdString(entry.path().filename().generic_string());
+        QString path = QString::fromStdString(entry.path().generic_string());
+        // is_directory() follows links
+        if(entry.is_directory(ec)) {
+            if(maxDepth >= 0 && depth >= maxDepth)
+                continue;
+            if(entry.is_symlink(ec) && !followSymlinks)
+                continue;
+            if(isExcluded(path, name) || !markVisited(path))
+                continue;
+            pool.start(new CrawlTask(this, path, depth + 1));
+        } else if(regex.match(name).hasMatch()) {
+            FSEntry newEntry(path, name, false);
+            newEntry.size = entry.file_size(ec);
+            if(ec)
+                continue;
+            newEntry.modifyTime = entry.last_write_time(ec);
+            if(ec)
+                continue;
+            files.emplace_back(newEntry);
+        }
+    }
+    if(files.empty())
+        return;
+    QMutexLocker lock(&batchMutex);
+    if(batchHandler)
+        batchHandler(files);
+}
+
+bool DirectoryCrawler::isExcluded(const QString &dirPath, const QString &dirName) const {
+    if(excludes.isEmpty())
+        return false;
+    QString relativePath = dirPath.mid(rootPath.length());
+    if(relativePath.startsWith("/"))
+        relativePath.remove(0, 1);
+    for(auto &re : excludes) {
+        if(re.match(dirName).hasMatch() || re.match(relativePath).hasMatch())
+            return true;
+    }
+    return false;
+}
+
+bool DirectoryCrawler::markVisited(const QString &dirPath) {
+    QString id;
+#ifdef Q_OS_UNIX
+    struct stat st;
+    if(stat(QFile::encodeName(dirPath).constData(), &st) != 0)
+        return false;
+    id = QString::number(st.st_dev) + ":" + QString::number(st.st_ino);
+#else
+    id = QFileInfo(dirPath).canonicalFilePath();
+    if(id.isEmpty())
+        return false;
+#endif
+    QMutexLocker lock(&visitedMutex);
+    if(visited.contains(id))
+        return false;
+    visited.insert(id);
+    return true;
+}
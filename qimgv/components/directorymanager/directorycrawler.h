@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+#include <QSet>
+#include <QRegularExpression>
+#include <QDebug>
+#include <functional>
+#include <filesystem>
+#include <vector>
+#include "sourcecontainers/fsentry.h"
+#include "utils/stuff.h"
+
+// Walks a directory tree with several threads at once, one task per
+// subdirectory. On network storage every readdir / stat is a round trip,
+// so doing them in parallel is what makes a big archive load in seconds
+// instead of minutes.
+//
+// Files come out in batches (one per directory) in no particular order.
+class DirectoryCrawler {
+public:
+    // regex: file names to pick up
+    explicit DirectoryCrawler(QRegularExpression _regex);
+    ~DirectoryCrawler();
+
+    // levels of subdirectories to go into; -1 for no limit, 0 for the root only
+    void setMaxDepth(int depth);
+    // wildcards, matched against the directory name and its path relative to the root
+    void setExcludePatterns(QStringList patterns);
+    // directory symlinks are skipped by default
+    void setFollowSymlinks(bool mode);
+    void setThreadCount(int count);
+
+    // Blocks until the whole tree is read.
+    // onBatch is called from the worker threads, but never concurrently.
+    void crawl(QString rootPath, std::function<void(std::vector<FSEntry> &)> onBatch);
+    // same, collecting everything
+    std::vector<FSEntry> crawl(QString rootPath);
+
+private:
+    friend class CrawlTask;
+    void readDirectory(QString dirPath, int depth);
+    bool isExcluded(const QString &dirPath, const QString &dirName) const;
+    // false if this directory was seen already (symlink loop, bind mount)
+    bool markVisited(const QString &dirPath);
+
+    QThreadPool pool;
+    QRegularExpression regex;
+    QList<QRegularExpression> excludes;
+    int maxDepth;
+    bool followSymlinks;
+
+    // per crawl()
+    QString rootPath;
+    std::function<void(std::vector<FSEntry> &)> batchHandler;
+    QMutex batchMutex, visitedMutex;
+    QSet<QString> visited;
+};
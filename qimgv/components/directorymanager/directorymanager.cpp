@@ -2,12 +2,25 @@
 
 namespace fs = std::filesystem;
 
+// listings that take less than this to read are not worth a snapshot
+#define SNAPSHOT_MIN_SCAN_TIME  100 // ms
+// metadata is collected for this long before the list is re-sorted
+#define METADATA_APPLY_INTERVAL 500 // ms
+
 DirectoryManager::DirectoryManager() :
     watcher(nullptr),
-    mSortingMode(SORT_NAME)
+    mSortingMode(SORT_NAME),
+    scanId(0),
+    metadataGeneration(0),
+    metadataRequested(false)
 {
     regex.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
     collator.setNumericMode(true);
+    scanPool.setMaxThreadCount(1);
+    metadataTimer.setSingleShot(true);
+    metadataTimer.setInterval(METADATA_APPLY_INTERVAL);
+    connect(&metadataTimer, &QTimer::timeout, this, &DirectoryManager::applyMetadata);
+    connect(&indexer, &MetadataIndexer::metadataReady, this, &DirectoryManager::onMetadataReady);
 
     readSettings();
     setSortingMode(settings->sortingMode());
@@ -52,6 +65,109 @@ bool DirectoryManager::size_entry_compare_reverse(const FSEntry& e1, const FSEnt
     return e1.size > e2.size;
 }
 
+int DirectoryManager::file_path_order(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    // different folders only happen in recursive mode
+    if(e1.dir != e2.dir) {
+        int order = collator.compare(fileEntries.dirPath(e1), fileEntries.dirPath(e2));
+        if(order)
+            return order;
+    }
+    QStringView n1 = fileEntries.nameView(e1), n2 = fileEntries.nameView(e2);
+    return collator.compare(n1.data(), static_cast<int>(n1.size()), n2.data(), static_cast<int>(n2.size()));
+}
+
+bool DirectoryManager::file_path_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    return file_path_order(e1, e2) < 0;
+}
+
+bool DirectoryManager::file_path_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    return file_path_order(e1, e2) > 0;
+}
+
+bool DirectoryManager::file_date_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    return e1.modifyTime < e2.modifyTime;
+}
+
+bool DirectoryManager::file_date_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    return e1.modifyTime > e2.modifyTime;
+}
+
+bool DirectoryManager::file_size_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    return e1.size < e2.size;
+}
+
+bool DirectoryManager::file_size_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    return e1.size > e2.size;
+}
+
+// Files not indexed yet (or without the value) go last in either direction.
+// Ties are broken by path, so the order does not jump around between sorts.
+int DirectoryManager::file_key_order(bool known1, bool known2, qint64 key1, qint64 key2, const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    if(known1 != known2)
+        return known1 ? -1 : 1;
+    if(key1 != key2)
+        return key1 < key2 ? -1 : 1;
+    return file_path_order(e1, e2);
+}
+
+// without a capture date: by modification time, after the rest
+bool DirectoryManager::file_capture_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    bool known1 = e1.captureTime >= 0, known2 = e2.captureTime >= 0;
+    return file_key_order(known1, known2, known1 ? e1.captureTime : e1.modifyTime,
+                          known2 ? e2.captureTime : e2.modifyTime, e1, e2) < 0;
+}
+
+bool DirectoryManager::file_capture_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    bool known1 = e1.captureTime >= 0, known2 = e2.captureTime >= 0;
+    if(known1 != known2)
+        return known1;
+    return file_key_order(known1, known2, known1 ? e1.captureTime : e1.modifyTime,
+                          known2 ? e2.captureTime : e2.modifyTime, e1, e2) > 0;
+}
+
+bool DirectoryManager::file_resolution_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    qint64 pixels1 = qint64(e1.width) * e1.height, pixels2 = qint64(e2.width) * e2.height;
+    return file_key_order(pixels1 > 0, pixels2 > 0, pixels1, pixels2, e1, e2) < 0;
+}
+
+bool DirectoryManager::file_resolution_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    qint64 pixels1 = qint64(e1.width) * e1.height, pixels2 = qint64(e2.width) * e2.height;
+    if((pixels1 > 0) != (pixels2 > 0))
+        return pixels1 > 0;
+    return file_key_order(true, true, pixels1, pixels2, e1, e2) > 0;
+}
+
+// static, animated, video
+bool DirectoryManager::file_type_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const {
+    bool known1 = e1.type != DocumentType::NONE, known2 = e2.type != DocumentType::NONE;
+    return file_key_order(known1, known2, e1.type, e2.type, e1, e2) < 0;
+}
+
+FileCompareFunction DirectoryManager::fileCompareFunction() {
+    FileCompareFunction cmpFn = &DirectoryManager::file_path_compare;
+    if(mSortingMode == SortingMode::SORT_NAME_DESC)
+        cmpFn = &DirectoryManager::file_path_compare_reverse;
+    if(mSortingMode == SortingMode::SORT_TIME)
+        cmpFn = &DirectoryManager::file_date_compare;
+    if(mSortingMode == SortingMode::SORT_TIME_DESC)
+        cmpFn = &DirectoryManager::file_date_compare_reverse;
+    if(mSortingMode == SortingMode::SORT_SIZE)
+        cmpFn = &DirectoryManager::file_size_compare;
+    if(mSortingMode == SortingMode::SORT_SIZE_DESC)
+        cmpFn = &DirectoryManager::file_size_compare_reverse;
+    if(mSortingMode == SortingMode::SORT_CAPTURE_TIME)
+        cmpFn = &DirectoryManager::file_capture_compare;
+    if(mSortingMode == SortingMode::SORT_CAPTURE_TIME_DESC)
+        cmpFn = &DirectoryManager::file_capture_compare_reverse;
+    if(mSortingMode == SortingMode::SORT_RESOLUTION)
+        cmpFn = &DirectoryManager::file_resolution_compare;
+    if(mSortingMode == SortingMode::SORT_RESOLUTION_DESC)
+        cmpFn = &DirectoryManager::file_resolution_compare_reverse;
+    if(mSortingMode == SortingMode::SORT_TYPE)
+        cmpFn = &DirectoryManager::file_type_compare;
+    return cmpFn;
+}
+
 CompareFunction DirectoryManager::compareFunction() {
     CompareFunction cmpFn = &DirectoryManager::path_entry_compare;
     if(mSortingMode == SortingMode::SORT_NAME_DESC)
@@ -100,6 +216,10 @@ void DirectoryManager::stopFileWatcher() {
 
 void DirectoryManager::readSettings() {
     regex.setPattern(settings->supportedFormatsRegex());
+    MetadataFilter filter;
+    filter.minSize = settings->filterMinResolution();
+    filter.types = settings->filterDocumentTypes();
+    setMetadataFilter(filter);
 }
 
 bool DirectoryManager::setDirectory(QString dirPath) {
@@ -121,14 +241,130 @@ bool DirectoryManager::setDirectory(QString dirPath) {
     }
     mListSource = SOURCE_DIRECTORY;
     mDirectoryPath = dirPath;
-
-    loadEntryList(dirPath, false);
-    sortEntryLists();
+    // drop any reconcile still running for the previous one
+    scanId++;
+    resetMetadata();
+
+    if(!loadSnapshot(dirPath)) {
+        ListingSnapshot snapshot(dirPath);
+        snapshot.stampDirectory();
+        QElapsedTimer scanTime;
+        scanTime.start();
+        loadEntryList(dirPath, false);
+        sortEntryLists();
+        if(settings->listingSnapshots() && scanTime.elapsed() >= SNAPSHOT_MIN_SCAN_TIME)
+            saveSnapshot(snapshot);
+    }
     emit loaded(dirPath);
     startFileWatcher(dirPath);
+    requestMetadata();
+    return true;
+}
+
+// Shows the last known listing right away. If the directory changed since,
+// it gets enumerated in background and the difference is applied
+// through the usual fileAdded / fileRemoved signals.
+bool DirectoryManager::loadSnapshot(QString directoryPath) {
+    if(!settings->listingSnapshots())
+        return false;
+    ListingSnapshot snapshot(directoryPath);
+    if(!snapshot.read() || snapshot.filter != regex.pattern())
+        return false;
+    PerfScope scope("directory snapshot", directoryPath);
+    fileEntries = std::move(snapshot.files);
+    dirEntryVec = std::move(snapshot.dirs);
+    if(snapshot.sortingMode != mSortingMode || snapshot.sortFolders != settings->sortFolders())
+        sortEntryLists();
+    if(!snapshot.isCurrent()) {
+        auto runnable = new DirectoryScanRunnable(directoryPath, regex, scanId);
+        connect(runnable, &DirectoryScanRunnable::finished, this, &DirectoryManager::onSnapshotReconciled);
+        runnable->setAutoDelete(true);
+        scanPool.start(runnable);
+    }
     return true;
 }
 
+// stamps in the snapshot must be from before the entry lists were read
+void DirectoryManager::saveSnapshot(ListingSnapshot &snapshot) const {
+    snapshot.filter = regex.pattern();
+    snapshot.sortingMode = mSortingMode;
+    snapshot.sortFolders = settings->sortFolders();
+    snapshot.files = fileEntries;
+    snapshot.dirs = dirEntryVec;
+    snapshot.write();
+}
+
+void DirectoryManager::onSnapshotReconciled(int id, std::shared_ptr<ListingSnapshot> listing) {
+    if(id != scanId || mListSource != SOURCE_DIRECTORY || listing->directoryPath != mDirectoryPath)
+        return;
+    PerfScope scope("directory reconcile", mDirectoryPath);
+    QHash<QString, size_t> scannedFiles;
+    QSet<QString> knownFiles, scannedDirs, knownDirs;
+    for(size_t i = 0; i < listing->files.size(); i++)
+        scannedFiles.insert(listing->files.path(i), i);
+    for(auto &entry : listing->dirs)
+        scannedDirs.insert(entry.path);
+
+    // filtered out: gone, or still here and not new
+    for(auto it = hiddenEntries.begin(); it != hiddenEntries.end();) {
+        QString path = fileEntries.path(*it);
+        if(scannedFiles.contains(path)) {
+            knownFiles.insert(path);
+            ++it;
+        } else {
+            fileEntries.releaseName(*it);
+            it = hiddenEntries.erase(it);
+        }
+    }
+
+    // removed & modified
+    QStringList removed, modified;
+    for(auto &entry : fileEntries) {
+        QString path = fileEntries.path(entry);
+        knownFiles.insert(path);
+        auto scanned = scannedFiles.constFind(path);
+        if(scanned == scannedFiles.constEnd()) {
+            removed.append(path);
+            continue;
+        }
+        auto &scannedEntry = listing->files.at(scanned.value());
+        if(scannedEntry.size != entry.size || scannedEntry.modifyTime != entry.modifyTime) {
+            entry.size = scannedEntry.size;
+            entry.modifyTime = scannedEntry.modifyTime;
+            entry.indexed = 0;
+            if(metadataRequested)
+                requestMetadata(entry);
+            modified.append(path);
+        }
+    }
+    for(auto &path : modified)
+        emit fileModified(path);
+    for(auto &path : removed)
+        removeFileEntry(path);
+    for(size_t i = 0; i < listing->files.size(); i++)
+        if(!knownFiles.contains(listing->files.path(i)))
+            addFileEntry(listing->files.fsEntry(i));
+
+    removed.clear();
+    for(auto &entry : dirEntryVec) {
+        knownDirs.insert(entry.path);
+        if(!scannedDirs.contains(entry.path))
+            removed.append(entry.path);
+    }
+    for(auto &path : removed)
+        removeDirEntry(path);
+    for(auto &entry : listing->dirs)
+        if(!knownDirs.contains(entry.path))
+            insertDirEntry(entry.path);
+
+    // modified entries may be out of place now
+    if(!modified.isEmpty() && mSortingMode != SORT_NAME && mSortingMode != SORT_NAME_DESC) {
+        sortEntryLists();
+        emit sortingChanged();
+    }
+    saveSnapshot(*listing);
+}
+
 bool DirectoryManager::setDirectoryRecursive(QString dirPath) {
     if(dirPath.isEmpty()) {
         return false;
@@ -144,9 +380,12 @@ bool DirectoryManager::setDirectoryRecursive(QString dirPath) {
     stopFileWatcher();
     mListSource = SOURCE_DIRECTORY_RECURSIVE;
     mDirectoryPath = dirPath;
+    scanId++;
+    resetMetadata();
     loadEntryList(dirPath, true);
     sortEntryLists();
     emit loaded(dirPath);
+    requestMetadata();
     return true;
 }
 
@@ -158,12 +397,7 @@ QString DirectoryManager::directoryPath() const {
 }
 
 int DirectoryManager::indexOfFile(QString filePath) const {
-    auto item = find_if(fileEntryVec.begin(), fileEntryVec.end(), [filePath](const FSEntry& e) {
-        return e.path == filePath;
-    });
-    if(item != fileEntryVec.end())
-        return distance(fileEntryVec.begin(), item);
-    return -1;
+    return fileEntries.indexOf(filePath);
 }
 
 int DirectoryManager::indexOfDir(QString dirPath) const {
@@ -176,11 +410,11 @@ int DirectoryManager::indexOfDir(QString dirPath) const {
 }
 
 QString DirectoryManager::filePathAt(int index) const {
-    return checkFileRange(index) ? fileEntryVec.at(index).path : "";
+    return checkFileRange(index) ? fileEntries.path(index) : "";
 }
 
 QString DirectoryManager::fileNameAt(int index) const {
-    return checkFileRange(index) ? fileEntryVec.at(index).name : "";
+    return checkFileRange(index) ? fileEntries.name(index) : "";
 }
 
 QString DirectoryManager::dirPathAt(int index) const {
@@ -193,15 +427,15 @@ QString DirectoryManager::dirNameAt(int index) const {
 
 QString DirectoryManager::firstFile() const {
     QString filePath = "";
-    if(fileEntryVec.size())
-        filePath = fileEntryVec.front().path;
+    if(fileEntries.size())
+        filePath = fileEntries.path(0);
     return filePath;
 }
 
 QString DirectoryManager::lastFile() const {
     QString filePath = "";
-    if(fileEntryVec.size())
-        filePath = fileEntryVec.back().path;
+    if(fileEntries.size())
+        filePath = fileEntries.path(fileEntries.size() - 1);
     return filePath;
 }
 
@@ -209,15 +443,15 @@ QString DirectoryManager::prevOfFile(QString filePath) const {
     QString prevFilePath = "";
     int currentIndex = indexOfFile(filePath);
     if(currentIndex > 0)
-        prevFilePath = fileEntryVec.at(currentIndex - 1).path;
+        prevFilePath = fileEntries.path(currentIndex - 1);
     return prevFilePath;
 }
 
 QString DirectoryManager::nextOfFile(QString filePath) const {
     QString nextFilePath = "";
     int currentIndex = indexOfFile(filePath);
-    if(currentIndex >= 0 && currentIndex < fileEntryVec.size() - 1)
-        nextFilePath = fileEntryVec.at(currentIndex + 1).path;
+    if(currentIndex >= 0 && currentIndex < (int)fileEntries.size() - 1)
+        nextFilePath = fileEntries.path(currentIndex + 1);
     return nextFilePath;
 }
 
@@ -238,7 +472,7 @@ QString DirectoryManager::nextOfDir(QString dirPath) const {
 }
 
 bool DirectoryManager::checkFileRange(int index) const {
-    return index >= 0 && index < (int)fileEntryVec.size();
+    return index >= 0 && index < (int)fileEntries.size();
 }
 
 bool DirectoryManager::checkDirRange(int index) const {
@@ -250,18 +484,18 @@ unsigned long DirectoryManager::totalCount() const {
 }
 
 unsigned long DirectoryManager::fileCount() const {
-    return fileEntryVec.size();
+    return fileEntries.size();
 }
 
 unsigned long DirectoryManager::dirCount() const {
     return dirEntryVec.size();
 }
 
-const FSEntry &DirectoryManager::fileEntryAt(int index) const {
+FSEntry DirectoryManager::fileEntryAt(int index) const {
     if(checkFileRange(index))
-        return fileEntryVec.at(index);
+        return fileEntries.fsEntry(index);
     else
-        return defaultEntry;
+        return FSEntry();
 }
 
 QDateTime DirectoryManager::lastModified(QString filePath) const {
@@ -294,11 +528,11 @@ bool DirectoryManager::isDir(QString path) const {
 }
 
 bool DirectoryManager::isEmpty() const {
-    return fileEntryVec.empty();
+    return fileEntries.empty();
 }
 
 bool DirectoryManager::containsFile(QString filePath) const {
-    return (std::find(fileEntryVec.begin(), fileEntryVec.end(), filePath) != fileEntryVec.end());
+    return fileEntries.indexOf(filePath) >= 0;
 }
 
 bool DirectoryManager::containsDir(QString dirPath) const {
@@ -309,17 +543,18 @@ bool DirectoryManager::containsDir(QString dirPath) const {
 // ###################### PRIVATE METHODS #######################
 // ##############################################################
 void DirectoryManager::loadEntryList(QString directoryPath, bool recursive) {
+    PerfScope scope("directory scan", directoryPath);
     dirEntryVec.clear();
-    fileEntryVec.clear();
+    fileEntries.clear();
     if(recursive) { // load files only
-        addEntriesFromDirectoryRecursive(fileEntryVec, directoryPath);
+        addEntriesFromDirectoryRecursive(fileEntries, directoryPath);
     } else { // load dirs & files
-        addEntriesFromDirectory(fileEntryVec, directoryPath);
+        addEntriesFromDirectory(fileEntries, dirEntryVec, directoryPath, regex);
     }
 }
 
 // both directories & files
-void DirectoryManager::addEntriesFromDirectory(std::vector<FSEntry> &entryVec, QString directoryPath) {
+void DirectoryManager::addEntriesFromDirectory(EntryTable &files, std::vector<FSEntry> &dirVec, QString directoryPath, const QRegularExpression &regex) {
     QRegularExpressionMatch match;
     for(const auto & entry : fs::directory_iterator(toStdString(directoryPath))) {
         QString name = QString::fromStdString(entry.path().filename().generic_string());
@@ -342,7 +577,7 @@ void DirectoryManager::addEntriesFromDirectory(std::vector<FSEntry> &entryVec, Q
                 qDebug() << "[DirectoryManager]" << err.what();
                 continue;
             }
-            dirEntryVec.emplace_back(newEntry);
+            dirVec.emplace_back(newEntry);
         } else if (match.hasMatch()) {
             FSEntry newEntry;
             try {
@@ -355,49 +590,43 @@ void DirectoryManager::addEntriesFromDirectory(std::vector<FSEntry> &entryVec, Q
                 qDebug() << "[DirectoryManager]" << err.what();
                 continue;
             }
-            entryVec.emplace_back(newEntry);
+            files.append(newEntry);
         }
     }
 }
 
-void DirectoryManager::addEntriesFromDirectoryRecursive(std::vector<FSEntry> &entryVec, QString directoryPath) {
-    QRegularExpressionMatch match;
-    for(const auto & entry : fs::recursive_directory_iterator(toStdString(directoryPath))) {
-        QString name = QString::fromStdString(entry.path().filename().generic_string());
-        QString path = QString::fromStdString(entry.path().generic_string());
-        match = regex.match(name);
-        if(!entry.is_directory() && match.hasMatch()) {
-            FSEntry newEntry;
-            try {
-                newEntry.name = name;
-                newEntry.path = path;
-                newEntry.isDirectory = false;
-                newEntry.size = entry.file_size();
-                newEntry.modifyTime = entry.last_write_time();
-            } catch (const std::filesystem::filesystem_error &err) {
-                qDebug() << "[DirectoryManager]" << err.what();
-                continue;
-            }
-            entryVec.emplace_back(newEntry);
-        }
-    }
+void DirectoryManager::addEntriesFromDirectoryRecursive(EntryTable &files, QString directoryPath) {
+    DirectoryCrawler crawler(regex);
+    crawler.setMaxDepth(settings->recursiveScanDepth());
+    crawler.setExcludePatterns(settings->recursiveScanExcludes());
+    crawler.setFollowSymlinks(settings->recursiveScanFollowSymlinks());
+    crawler.crawl(directoryPath, [&files](std::vector<FSEntry> &batch) {
+        for(auto &entry : batch)
+            files.append(entry);
+    });
 }
 
 void DirectoryManager::sortEntryLists() {
+    PerfScope scope("sort");
     if(settings->sortFolders())
         std::sort(dirEntryVec.begin(), dirEntryVec.end(), std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
     else
         std::sort(dirEntryVec.begin(), dirEntryVec.end(), std::bind(&DirectoryManager::path_entry_compare, this, std::placeholders::_1, std::placeholders::_2));
-    std::sort(fileEntryVec.begin(), fileEntryVec.end(), std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    sortFileEntries();
+}
+
+void DirectoryManager::sortFileEntries() {
+    std::sort(fileEntries.begin(), fileEntries.end(), std::bind(fileCompareFunction(), this, std::placeholders::_1, std::placeholders::_2));
 }
 
 void DirectoryManager::setSortingMode(SortingMode mode) {
     if(mode != mSortingMode) {
         mSortingMode = mode;
-        if(fileEntryVec.size() > 1 || dirEntryVec.size() > 1) {
+        if(fileEntries.size() > 1 || dirEntryVec.size() > 1) {
             sortEntryLists();
             emit sortingChanged();
         }
+        requestMetadata();
     }
 }
 
@@ -405,6 +634,136 @@ SortingMode DirectoryManager::sortingMode() const {
     return mSortingMode;
 }
 
+void DirectoryManager::setMetadataFilter(const MetadataFilter &filter) {
+    if(filter == mFilter)
+        return;
+    mFilter = filter;
+    if(applyFilter()) {
+        sortFileEntries();
+        emit listChanged();
+    }
+    requestMetadata();
+}
+
+MetadataFilter DirectoryManager::metadataFilter() const {
+    return mFilter;
+}
+
+// ---- metadata
+
+bool DirectoryManager::needsMetadata() const {
+    return mSortingMode >= SortingMode::SORT_CAPTURE_TIME || mFilter.isActive();
+}
+
+// for a new file list
+void DirectoryManager::resetMetadata() {
+    metadataGeneration++;
+    indexer.clearTasks();
+    metadataTimer.stop();
+    pendingMetadata.clear();
+    hiddenEntries.clear();
+    metadataRequested = false;
+}
+
+// Everything not indexed yet goes to the indexer, in list order;
+// files known to the index come back almost at once.
+void DirectoryManager::requestMetadata() {
+    if(metadataRequested || !needsMetadata() || directoryPath().isEmpty())
+        return;
+    metadataRequested = true;
+    QVector<MetadataRequest> requests;
+    for(auto &entry : fileEntries)
+        if(!entry.indexed)
+            requests.append({ fileEntries.path(entry), entry.size, entry.modifyTime, entry.nameOffset });
+    indexer.index(requests, metadataGeneration);
+}
+
+void DirectoryManager::requestMetadata(const EntryTable::Entry &entry) {
+    MetadataRequest request = { fileEntries.path(entry), entry.size, entry.modifyTime, entry.nameOffset };
+    indexer.index(QVector<MetadataRequest>() << request, metadataGeneration);
+}
+
+void DirectoryManager::onMetadataReady(int generation, QVector<MetadataResult> results) {
+    if(generation != metadataGeneration)
+        return;
+    for(auto &result : results)
+        pendingMetadata.insert(result.token, result.metadata);
+    // re-sorting for every batch would keep the views busy reloading
+    if(!metadataTimer.isActive())
+        metadataTimer.start();
+}
+
+void DirectoryManager::applyMetadata() {
+    if(pendingMetadata.isEmpty())
+        return;
+    PerfScope scope("apply metadata");
+    for(auto &entry : fileEntries) {
+        auto it = pendingMetadata.constFind(entry.nameOffset);
+        if(it == pendingMetadata.constEnd())
+            continue;
+        auto &metadata = it.value();
+        entry.type = static_cast<quint8>(metadata.type);
+        entry.width = static_cast<quint16>(qBound(0, metadata.width, 0xFFFF));
+        entry.height = static_cast<quint16>(qBound(0, metadata.height, 0xFFFF));
+        entry.captureTime = metadata.captureTime;
+        entry.indexed = 1;
+    }
+    pendingMetadata.clear();
+    bool changed = applyFilter();
+    auto cmpFn = std::bind(fileCompareFunction(), this, std::placeholders::_1, std::placeholders::_2);
+    if(changed || !std::is_sorted(fileEntries.begin(), fileEntries.end(), cmpFn)) {
+        sortFileEntries();
+        emit listChanged();
+    }
+}
+
+// Names of removed files stay in the arena; rebuild it once they make up most of it.
+// Name offsets are the metadata tokens, so the ones still with the indexer are asked again.
+void DirectoryManager::compactNames() {
+    if(!fileEntries.namesNeedCompaction())
+        return;
+    QHash<quint32, quint32> remap;
+    fileEntries.compactNames(hiddenEntries, remap);
+    QHash<quint32, FileMetadata> pending;
+    for(auto it = pendingMetadata.constBegin(); it != pendingMetadata.constEnd(); ++it) {
+        auto newOffset = remap.constFind(it.key());
+        if(newOffset != remap.constEnd())
+            pending.insert(newOffset.value(), it.value());
+    }
+    pendingMetadata.swap(pending);
+    if(metadataRequested) {
+        indexer.clearTasks();
+        metadataGeneration++;
+        metadataRequested = false;
+        requestMetadata();
+    }
+}
+
+// Moves indexed files in and out of the list as the filter says.
+// Returns true if anything moved; the list needs sorting after that.
+bool DirectoryManager::applyFilter() {
+    bool changed = false;
+    for(auto it = hiddenEntries.begin(); it != hiddenEntries.end();) {
+        if(mFilter.accepts(static_cast<DocumentType>(it->type), it->width, it->height)) {
+            fileEntries.append(*it);
+            it = hiddenEntries.erase(it);
+            changed = true;
+        } else {
+            ++it;
+        }
+    }
+    auto accepted = [this](const EntryTable::Entry &entry) {
+        return !entry.indexed || mFilter.accepts(static_cast<DocumentType>(entry.type), entry.width, entry.height);
+    };
+    auto rejected = std::stable_partition(fileEntries.begin(), fileEntries.end(), accepted);
+    if(rejected != fileEntries.end()) {
+        hiddenEntries.insert(hiddenEntries.end(), rejected, fileEntries.end());
+        fileEntries.truncate(static_cast<size_t>(std::distance(fileEntries.begin(), rejected)));
+        changed = true;
+    }
+    return changed;
+}
+
 // Entry management
 
 bool DirectoryManager::insertFileEntry(const QString &filePath) {
@@ -419,20 +778,41 @@ bool DirectoryManager::forceInsertFileEntry(const QString &filePath) {
         return false;
     std::filesystem::directory_entry stdEntry(toStdString(filePath));
     QString fileName = QString::fromStdString(stdEntry.path().filename().generic_string()); // isn't it beautiful
-    FSEntry FSEntry(filePath, fileName, stdEntry.file_size(), stdEntry.last_write_time(), stdEntry.is_directory());
-    insert_sorted(fileEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    addFileEntry(FSEntry(filePath, fileName, stdEntry.file_size(), stdEntry.last_write_time(), stdEntry.is_directory()));
+    return true;
+}
+
+void DirectoryManager::insertFileSorted(const FSEntry &entry) {
+    auto newEntry = fileEntries.makeEntry(entry);
+    auto it = std::upper_bound(fileEntries.begin(), fileEntries.end(), newEntry, std::bind(fileCompareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    fileEntries.insert(std::distance(fileEntries.begin(), it), newEntry);
+    if(metadataRequested)
+        requestMetadata(newEntry);
+}
+
+void DirectoryManager::addFileEntry(const FSEntry &entry) {
+    insertFileSorted(entry);
     if(!directoryPath().isEmpty()) {
-        qDebug() << "fileIns" << filePath << directoryPath();
-        emit fileAdded(filePath);
+        qDebug() << "fileIns" << entry.path << directoryPath();
+        emit fileAdded(entry.path);
     }
-    return true;
 }
 
 void DirectoryManager::removeFileEntry(const QString &filePath) {
-    if(!containsFile(filePath))
+    if(!containsFile(filePath)) {
+        for(auto it = hiddenEntries.begin(); it != hiddenEntries.end(); ++it) {
+            if(fileEntries.path(*it) == filePath) {
+                fileEntries.releaseName(*it);
+                hiddenEntries.erase(it);
+                break;
+            }
+        }
+        compactNames();
         return;
+    }
     int index = indexOfFile(filePath);
-    fileEntryVec.erase(fileEntryVec.begin() + index);
+    fileEntries.erase(index);
+    compactNames();
     qDebug() << "fileRem" << filePath;
     emit fileRemoved(filePath, index);
 }
@@ -442,8 +822,15 @@ void DirectoryManager::updateFileEntry(const QString &filePath) {
         return;
     FSEntry newEntry(filePath);
     int index = indexOfFile(filePath);
-    if(fileEntryVec.at(index).modifyTime != newEntry.modifyTime)
-        fileEntryVec.at(index) = newEntry;
+    auto &entry = fileEntries.at(index);
+    qint64 modifyTime = EntryTable::fromFileTime(newEntry.modifyTime);
+    if(entry.modifyTime != modifyTime) {
+        entry.size = newEntry.size;
+        entry.modifyTime = modifyTime;
+        entry.indexed = 0;
+        if(metadataRequested)
+            requestMetadata(entry);
+    }
     qDebug() << "fileMod" << filePath;
     emit fileModified(filePath);
 }
@@ -464,16 +851,16 @@ void DirectoryManager::renameFileEntry(const QString &oldFilePath, const QString
     }
     if(containsFile(newFilePath)) {
         int replaceIndex = indexOfFile(newFilePath);
-        fileEntryVec.erase(fileEntryVec.begin() + replaceIndex);
+        fileEntries.erase(replaceIndex);
         emit fileRemoved(newFilePath, replaceIndex);
     }
     // remove the old one
     int oldIndex = indexOfFile(oldFilePath);
-    fileEntryVec.erase(fileEntryVec.begin() + oldIndex);
+    fileEntries.erase(oldIndex);
     // insert
     std::filesystem::directory_entry stdEntry(toStdString(newFilePath));
-    FSEntry FSEntry(newFilePath, newFileName, stdEntry.file_size(), stdEntry.last_write_time(), stdEntry.is_directory());
-    insert_sorted(fileEntryVec, FSEntry, std::bind(compareFunction(), this, std::placeholders::_1, std::placeholders::_2));
+    insertFileSorted(FSEntry(newFilePath, newFileName, stdEntry.file_size(), stdEntry.last_write_time(), stdEntry.is_directory()));
+    compactNames();
     qDebug() << "fileRen" << oldFilePath << newFilePath;
     emit fileRenamed(oldFilePath, oldIndex, newFilePath, indexOfFile(newFilePath));
 }
@@ -529,10 +916,7 @@ FileListSource DirectoryManager::source() const {
 }
 
 QStringList DirectoryManager::fileList() const {
-    QStringList list;
-    for(auto const& value : fileEntryVec)
-        list << value.path;
-    return list;
+    return fileEntries.paths();
 }
 
 bool DirectoryManager::fileWatcherActive() {
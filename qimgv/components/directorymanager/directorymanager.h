@@ -8,6 +8,10 @@
 #include <QDebug>
 #include <QDateTime>
 #include <QRegularExpression>
+#include <QHash>
+#include <QSet>
+#include <QThreadPool>
+#include <QTimer>
 
 #include <vector>
 #include <string>
@@ -17,7 +21,13 @@
 
 #include "settings.h"
 #include "watchers/directorywatcher.h"
+#include "listingsnapshot.h"
+#include "directoryscanrunnable.h"
+#include "directorycrawler.h"
+#include "entrytable.h"
+#include "components/metadataindex/metadataindexer.h"
 #include "utils/stuff.h"
+#include "utils/perftrace.h"
 #include "sourcecontainers/fsentry.h"
 
 enum FileListSource { // rename? wip
@@ -29,6 +39,7 @@ enum FileListSource { // rename? wip
 class DirectoryManager;
 
 typedef bool (DirectoryManager::*CompareFunction)(const FSEntry &e1, const FSEntry &e2) const;
+typedef bool (DirectoryManager::*FileCompareFunction)(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
 
 //TODO: rename? EntrySomething?
 
@@ -60,12 +71,15 @@ public:
     QString lastFile() const;
     void setSortingMode(SortingMode mode);
     SortingMode sortingMode() const;
+    // Files are judged once indexed; until then they stay in the list.
+    void setMetadataFilter(const MetadataFilter &filter);
+    MetadataFilter metadataFilter() const;
     bool isFile(QString path) const;
     bool isDir(QString path) const;
 
     unsigned long totalCount() const;
     bool containsDir(QString dirPath) const;
-    const FSEntry &fileEntryAt(int index) const;
+    FSEntry fileEntryAt(int index) const;
     QString dirPathAt(int index) const;
     QString dirNameAt(int index) const;
     bool fileWatcherActive();
@@ -86,11 +100,15 @@ public:
 
     QStringList fileList() const;
 
+    // files matching regex go to fileVec, all dirs to dirVec
+    // thread-safe; does not touch the manager itself
+    static void addEntriesFromDirectory(EntryTable &files, std::vector<FSEntry> &dirVec, QString directoryPath, const QRegularExpression &regex);
+
 private:
     QRegularExpression regex;
     QCollator collator;
-    std::vector<FSEntry> fileEntryVec, dirEntryVec;
-    const FSEntry defaultEntry;
+    EntryTable fileEntries;
+    std::vector<FSEntry> dirEntryVec;
     QString mDirectoryPath;
 
     DirectoryWatcher* watcher;
@@ -98,6 +116,34 @@ private:
     SortingMode mSortingMode;
     FileListSource mListSource;
     void loadEntryList(QString directoryPath, bool recursive);
+    bool loadSnapshot(QString directoryPath);
+    void saveSnapshot(ListingSnapshot &snapshot) const;
+    void addFileEntry(const FSEntry &entry);
+    void insertFileSorted(const FSEntry &entry);
+
+    // directory i/o, kept off the executor which is for cpu work
+    QThreadPool scanPool;
+    int scanId;
+
+    // sort modes and the filter that need more than what the listing has
+    MetadataIndexer indexer;
+    MetadataFilter mFilter;
+    // indexed files that did not pass the filter
+    std::vector<EntryTable::Entry> hiddenEntries;
+    // arrived, but not in the list yet; by entry nameOffset
+    QHash<quint32, FileMetadata> pendingMetadata;
+    // passed to the indexer; results from before a reset / compaction are dropped
+    int metadataGeneration;
+    QTimer metadataTimer;
+    // whole list was sent to the indexer; new entries go on their own
+    bool metadataRequested;
+    bool needsMetadata() const;
+    void resetMetadata();
+    void requestMetadata();
+    void requestMetadata(const EntryTable::Entry &entry);
+    bool applyFilter();
+    void compactNames();
+    void sortFileEntries();
 
     bool path_entry_compare(const FSEntry &e1, const FSEntry &e2) const;
     bool path_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const;
@@ -106,13 +152,27 @@ private:
     bool date_entry_compare(const FSEntry &e1, const FSEntry &e2) const;
     bool date_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const;
     CompareFunction compareFunction();
+    // files are kept in an EntryTable and have their own set
+    int file_path_order(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_path_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_path_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_date_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_date_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_size_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_size_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    int file_key_order(bool known1, bool known2, qint64 key1, qint64 key2, const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_capture_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_capture_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_resolution_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_resolution_compare_reverse(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    bool file_type_compare(const EntryTable::Entry &e1, const EntryTable::Entry &e2) const;
+    FileCompareFunction fileCompareFunction();
     bool size_entry_compare(const FSEntry &e1, const FSEntry &e2) const;
     bool size_entry_compare_reverse(const FSEntry &e1, const FSEntry &e2) const;
     void startFileWatcher(QString directoryPath);
     void stopFileWatcher();
 
-    void addEntriesFromDirectory(std::vector<FSEntry> &entryVec, QString directoryPath);
-    void addEntriesFromDirectoryRecursive(std::vector<FSEntry> &entryVec, QString directoryPath);
+    void addEntriesFromDirectoryRecursive(EntryTable &files, QString directoryPath);
     bool checkFileRange(int index) const;
     bool checkDirRange(int index) const;
 
@@ -121,10 +181,15 @@ private slots:
     void onFileRemovedExternal(QString fileName);
     void onFileModifiedExternal(QString fileName);
     void onFileRenamedExternal(QString oldFileName, QString newFileName);
+    void onSnapshotReconciled(int id, std::shared_ptr<ListingSnapshot> listing);
+    void onMetadataReady(int generation, QVector<MetadataResult> results);
+    void applyMetadata();
 
 signals:
     void loaded(const QString &path);
     void sortingChanged();
+    // reordered or filtered on its own (metadata came in), not by the user
+    void listChanged();
     void fileRemoved(QString filePath, int);
     void fileModified(QString filePath);
     void fileAdded(QString filePath);
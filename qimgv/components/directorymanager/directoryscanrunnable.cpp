@@ -0,0 +1,22 @@
+#include "directoryscanrunnable.h"
+#include "directorymanager.h"
+
+DirectoryScanRunnable::DirectoryScanRunnable(QString _directoryPath, QRegularExpression _regex, int _scanId)
+    : directoryPath(_directoryPath),
+      regex(_regex),
+      scanId(_scanId)
+{
+}
+
+void DirectoryScanRunnable::run() {
+    auto listing = std::make_shared<ListingSnapshot>(directoryPath);
+    listing->filter = regex.pattern();
+    listing->stampDirectory();
+    try {
+        DirectoryManager::addEntriesFromDirectory(listing->files, listing->dirs, directoryPath, regex);
+    } catch (const std::filesystem::filesystem_error &err) {
+        qDebug() << "[DirectoryScanRunnable]" << err.what();
+        return;
+    }
+    emit finished(scanId, listing);
+}
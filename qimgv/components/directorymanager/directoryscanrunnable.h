@@ -0,0 +1,24 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QRegularExpression>
+#include <memory>
+#include "listingsnapshot.h"
+
+// Enumerates a directory off the gui thread.
+// Used to reconcile a listing that was shown from a snapshot.
+class DirectoryScanRunnable : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    DirectoryScanRunnable(QString _directoryPath, QRegularExpression _regex, int _scanId);
+    void run();
+
+private:
+    QString directoryPath;
+    QRegularExpression regex;
+    int scanId;
+
+signals:
+    void finished(int scanId, std::shared_ptr<ListingSnapshot> listing);
+};
@@ -0,0 +1,194 @@
+#include "entrytable.h"
+
+// smaller arenas are not worth rebuilding
+#define NAMES_COMPACT_MIN   (64 * 1024) // chars
+
+void EntryTable::clear() {
+    entries.clear();
+    entries.shrink_to_fit();
+    names.clear();
+    names.squeeze();
+    deadNames = 0;
+    dirs.clear();
+    dirLookup.clear();
+}
+
+void EntryTable::reserve(size_t count) {
+    entries.reserve(count);
+}
+
+size_t EntryTable::size() const {
+    return entries.size();
+}
+
+bool EntryTable::empty() const {
+    return entries.empty();
+}
+
+quint32 EntryTable::dirIndex(const QString &dirPath) {
+    auto it = dirLookup.constFind(dirPath);
+    if(it != dirLookup.constEnd())
+        return it.value();
+    quint32 index = static_cast<quint32>(dirs.size());
+    dirs.append(dirPath);
+    dirLookup.insert(dirPath, index);
+    return index;
+}
+
+EntryTable::Entry EntryTable::makeEntry(const QString &path, quint64 fileSize, std::filesystem::file_time_type modifyTime) {
+    int split = path.lastIndexOf('/') + 1;
+    Entry entry;
+    entry.dir = dirIndex(path.left(split));
+    entry.nameOffset = static_cast<quint32>(names.size());
+    entry.nameLength = static_cast<quint16>(path.size() - split);
+    entry.type = 0;
+    entry.indexed = 0;
+    entry.width = 0;
+    entry.height = 0;
+    entry.size = fileSize;
+    entry.modifyTime = fromFileTime(modifyTime);
+    entry.captureTime = -1;
+    names.append(path.constData() + split, path.size() - split);
+    return entry;
+}
+
+EntryTable::Entry EntryTable::makeEntry(const FSEntry &entry) {
+    return makeEntry(entry.path, entry.size, entry.modifyTime);
+}
+
+void EntryTable::append(const FSEntry &entry) {
+    entries.push_back(makeEntry(entry));
+}
+
+void EntryTable::append(const Entry &entry) {
+    entries.push_back(entry);
+}
+
+void EntryTable::insert(size_t index, const Entry &entry) {
+    entries.insert(entries.begin() + static_cast<long>(index), entry);
+}
+
+void EntryTable::erase(size_t index) {
+    releaseName(entries.at(index));
+    entries.erase(entries.begin() + static_cast<long>(index));
+}
+
+void EntryTable::truncate(size_t count) {
+    if(count < entries.size())
+        entries.resize(count);
+}
+
+void EntryTable::releaseName(const Entry &entry) {
+    deadNames += entry.nameLength;
+}
+
+bool EntryTable::namesNeedCompaction() const {
+    if(names.size() < NAMES_COMPACT_MIN)
+        return false;
+    // more than half is dead
+    return deadNames * 2 > names.size();
+}
+
+void EntryTable::compactNames(std::vector<Entry> &extra, QHash<quint32, quint32> &remap) {
+    QString compacted;
+    compacted.reserve(static_cast<int>(names.size() / 2));
+    auto move = [&](Entry &entry) {
+        quint32 offset = static_cast<quint32>(compacted.size());
+        compacted.append(names.constData() + entry.nameOffset, static_cast<int>(entry.nameLength));
+        remap.insert(entry.nameOffset, offset);
+        entry.nameOffset = offset;
+    };
+    for(auto &entry : entries)
+        move(entry);
+    for(auto &entry : extra)
+        move(entry);
+    compacted.squeeze();
+    names.swap(compacted);
+    deadNames = 0;
+}
+
+const EntryTable::Entry &EntryTable::at(size_t index) const {
+    return entries.at(index);
+}
+
+EntryTable::Entry &EntryTable::at(size_t index) {
+    return entries.at(index);
+}
+
+std::vector<EntryTable::Entry>::iterator EntryTable::begin() {
+    return entries.begin();
+}
+
+std::vector<EntryTable::Entry>::iterator EntryTable::end() {
+    return entries.end();
+}
+
+std::vector<EntryTable::Entry>::const_iterator EntryTable::begin() const {
+    return entries.begin();
+}
+
+std::vector<EntryTable::Entry>::const_iterator EntryTable::end() const {
+    return entries.end();
+}
+
+QStringView EntryTable::nameView(const Entry &entry) const {
+    return QStringView(names.constData() + entry.nameOffset, static_cast<qsizetype>(entry.nameLength));
+}
+
+const QString &EntryTable::dirPath(const Entry &entry) const {
+    return dirs.at(static_cast<int>(entry.dir));
+}
+
+QString EntryTable::path(const Entry &entry) const {
+    const QString &dir = dirPath(entry);
+    QString result;
+    result.reserve(dir.size() + static_cast<int>(entry.nameLength));
+    result.append(dir);
+    result.append(names.constData() + entry.nameOffset, static_cast<int>(entry.nameLength));
+    return result;
+}
+
+QString EntryTable::path(size_t index) const {
+    return path(entries.at(index));
+}
+
+QString EntryTable::name(size_t index) const {
+    auto &entry = entries.at(index);
+    return QString(names.constData() + entry.nameOffset, static_cast<int>(entry.nameLength));
+}
+
+FSEntry EntryTable::fsEntry(size_t index) const {
+    auto &entry = entries.at(index);
+    return FSEntry(path(entry), name(index), entry.size, toFileTime(entry.modifyTime), false);
+}
+
+int EntryTable::indexOf(const QString &path) const {
+    int split = path.lastIndexOf('/') + 1;
+    auto it = dirLookup.constFind(path.left(split));
+    if(it == dirLookup.constEnd())
+        return -1;
+    quint32 dir = it.value();
+    QStringView name = QStringView(path).mid(split);
+    for(size_t i = 0; i < entries.size(); i++) {
+        auto &entry = entries[i];
+        if(entry.dir == dir && nameView(entry) == name)
+            return static_cast<int>(i);
+    }
+    return -1;
+}
+
+QStringList EntryTable::paths() const {
+    QStringList list;
+    list.reserve(static_cast<int>(entries.size()));
+    for(auto &entry : entries)
+        list << path(entry);
+    return list;
+}
+
+std::filesystem::file_time_type EntryTable::toFileTime(qint64 ticks) {
+    return std::filesystem::file_time_type(std::filesystem::file_time_type::duration(ticks));
+}
+
+qint64 EntryTable::fromFileTime(std::filesystem::file_time_type time) {
+    return static_cast<qint64>(time.time_since_epoch().count());
+}
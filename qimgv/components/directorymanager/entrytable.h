@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QHash>
+#include <vector>
+#include <filesystem>
+#include "sourcecontainers/fsentry.h"
+
+// Compact storage for file lists, which can get really long in recursive mode.
+//
+// Instead of two strings per file, the directory part of the path is
+// kept once per folder, and names are packed one after another into
+// a single string. What's left per file is a small fixed-size Entry.
+// Names are not moved around on erase(), they are just left unused;
+// the owner calls compactNames() once enough of the arena is dead.
+// Dead space is counted as entries go, so checking for it is cheap.
+class EntryTable {
+public:
+    struct Entry {
+        quint32 dir;        // index into the directory list
+        quint32 nameOffset; // position in the name arena; unique until clear() / compactNames()
+        quint16 nameLength;
+        // sort keys from the MetadataIndex; valid when indexed is set
+        quint8 type;        // DocumentType
+        quint8 indexed;
+        quint16 width;      // as displayed, saturated
+        quint16 height;
+        quint64 size;
+        qint64 modifyTime;  // file_time_type ticks
+        qint64 captureTime; // see FileMetadata
+    };
+
+    void clear();
+    void reserve(size_t count);
+    size_t size() const;
+    bool empty() const;
+
+    // entry is not added, only its strings; use with insert()
+    Entry makeEntry(const FSEntry &entry);
+    Entry makeEntry(const QString &path, quint64 fileSize, std::filesystem::file_time_type modifyTime);
+    void append(const FSEntry &entry);
+    void append(const Entry &entry);
+    void insert(size_t index, const Entry &entry);
+    void erase(size_t index);
+    // drops everything from count on; their names stay in use
+    // (the caller keeps the entries) until releaseName()
+    void truncate(size_t count);
+    // for entries dropped outside of this table
+    void releaseName(const Entry &entry);
+    bool namesNeedCompaction() const;
+    // Rebuilds the name arena from the entries and extra, leaving out removed names.
+    // Offsets change; remap gets old -> new.
+    void compactNames(std::vector<Entry> &extra, QHash<quint32, quint32> &remap);
+
+    const Entry &at(size_t index) const;
+    Entry &at(size_t index);
+    std::vector<Entry>::iterator begin();
+    std::vector<Entry>::iterator end();
+    std::vector<Entry>::const_iterator begin() const;
+    std::vector<Entry>::const_iterator end() const;
+
+    QString path(size_t index) const;
+    QString name(size_t index) const;
+    QString path(const Entry &entry) const;
+    QStringView nameView(const Entry &entry) const;
+    // folder part of the path, ends with a separator
+    const QString &dirPath(const Entry &entry) const;
+    FSEntry fsEntry(size_t index) const;
+    int indexOf(const QString &path) const;
+    QStringList paths() const;
+
+    static std::filesystem::file_time_type toFileTime(qint64 ticks);
+    static qint64 fromFileTime(std::filesystem::file_time_type time);
+
+private:
+    quint32 dirIndex(const QString &dirPath);
+
+    std::vector<Entry> entries;
+    QString names;
+    qint64 deadNames = 0; // chars in names no entry refers to anymore
+    QStringList dirs;
+    QHash<QString, quint32> dirLookup;
+};
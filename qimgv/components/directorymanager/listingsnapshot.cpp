@@ -0,0 +1,115 @@
+#include "listingsnapshot.h"
+
+#define SNAPSHOT_MAGIC      0x716c7374 // "qlst"
+#define SNAPSHOT_VERSION    1
+// some filesystems (fat, smb, older nfs) only keep whole seconds;
+// a change right after the snapshot was made could go unnoticed
+#define STAMP_GRANULARITY   2000 // ms
+
+ListingSnapshot::ListingSnapshot()
+    : sortingMode(SORT_NAME),
+      sortFolders(false),
+      dirModified(0),
+      dirChanged(0),
+      taken(0)
+{
+}
+
+ListingSnapshot::ListingSnapshot(QString _directoryPath)
+    : ListingSnapshot()
+{
+    directoryPath = _directoryPath;
+}
+
+QString ListingSnapshot::snapshotPath(QString directoryPath) {
+    QString id = QCryptographicHash::hash(directoryPath.toUtf8(), QCryptographicHash::Md5).toHex();
+    return settings->listingCacheDir() + id + ".lst";
+}
+
+QString ListingSnapshot::entryPath(const QString &name) const {
+    // same as directory_iterator would give us
+    if(directoryPath.endsWith("/"))
+        return directoryPath + name;
+    return directoryPath + "/" + name;
+}
+
+void ListingSnapshot::stampDirectory() {
+    QFileInfo info(directoryPath);
+    dirModified = info.lastModified().toMSecsSinceEpoch();
+    dirChanged = info.metadataChangeTime().toMSecsSinceEpoch();
+    taken = QDateTime::currentMSecsSinceEpoch();
+}
+
+bool ListingSnapshot::isCurrent() const {
+    if(taken - qMax(dirModified, dirChanged) < STAMP_GRANULARITY)
+        return false;
+    QFileInfo info(directoryPath);
+    return info.lastModified().toMSecsSinceEpoch() == dirModified &&
+           info.metadataChangeTime().toMSecsSinceEpoch() == dirChanged;
+}
+
+bool ListingSnapshot::read() {
+    QFile file(snapshotPath(directoryPath));
+    if(!file.open(QIODevice::ReadOnly))
+        return false;
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_5_12);
+    quint32 magic;
+    qint32 version;
+    in >> magic >> version;
+    if(magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION)
+        return false;
+    QString path;
+    qint32 mode;
+    quint32 dirCount, fileCount;
+    in >> path >> filter >> dirModified >> dirChanged >> taken >> mode >> sortFolders;
+    // md5 collision, or a damaged file
+    if(path != directoryPath || in.status() != QDataStream::Ok)
+        return false;
+    sortingMode = static_cast<SortingMode>(mode);
+
+    in >> dirCount;
+    dirs.clear();
+    dirs.reserve(qMin<quint32>(dirCount, 65536));
+    for(quint32 i = 0; i < dirCount && in.status() == QDataStream::Ok; i++) {
+        QString name;
+        in >> name;
+        dirs.emplace_back(entryPath(name), name, true);
+    }
+    in >> fileCount;
+    files.clear();
+    files.reserve(qMin<quint32>(fileCount, 1 << 20));
+    for(quint32 i = 0; i < fileCount && in.status() == QDataStream::Ok; i++) {
+        QString name;
+        quint64 size;
+        qint64 time;
+        in >> name >> size >> time;
+        files.append(files.makeEntry(entryPath(name), size, EntryTable::toFileTime(time)));
+    }
+    if(in.status() != QDataStream::Ok) {
+        qDebug() << "[ListingSnapshot] could not read snapshot for" << directoryPath;
+        files.clear();
+        dirs.clear();
+        return false;
+    }
+    return true;
+}
+
+void ListingSnapshot::write() const {
+    QSaveFile file(snapshotPath(directoryPath));
+    if(!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[ListingSnapshot] could not write" << file.fileName();
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << quint32(SNAPSHOT_MAGIC) << qint32(SNAPSHOT_VERSION);
+    out << directoryPath << filter << dirModified << dirChanged << taken << qint32(sortingMode) << sortFolders;
+    out << quint32(dirs.size());
+    for(auto &entry : dirs)
+        out << entry.name;
+    out << quint32(files.size());
+    for(auto &entry : files)
+        out << files.nameView(entry).toString() << quint64(entry.size) << qint64(entry.modifyTime);
+    file.commit();
+}
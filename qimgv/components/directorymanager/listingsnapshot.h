@@ -0,0 +1,46 @@
+#pragma once
+
+#include <QString>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QCryptographicHash>
+#include <QDebug>
+#include <vector>
+#include "settings.h"
+#include "sourcecontainers/fsentry.h"
+#include "entrytable.h"
+
+// On-disk copy of a directory listing (already sorted), so a folder we've
+// seen before can be shown without enumerating it first. Mostly helps on
+// network shares where a listing with stat() for each file takes seconds.
+//
+// A snapshot is considered up to date while the directory's own
+// mtime & ctime match; adding, removing or renaming a file changes them.
+// Files modified in place do not, that is left to the file watcher.
+class ListingSnapshot {
+public:
+    ListingSnapshot();
+    explicit ListingSnapshot(QString _directoryPath);
+
+    // false if there is no readable snapshot for this directory
+    bool read();
+    void write() const;
+    // reads the directory stamps; call before enumerating
+    void stampDirectory();
+    // directory stamps did not change since this snapshot was made
+    bool isCurrent() const;
+
+    QString directoryPath;
+    QString filter; // supported formats regex used for the file list
+    SortingMode sortingMode;
+    bool sortFolders;
+    EntryTable files;
+    std::vector<FSEntry> dirs;
+
+private:
+    static QString snapshotPath(QString directoryPath);
+    QString entryPath(const QString &name) const;
+    qint64 dirModified, dirChanged, taken;
+};
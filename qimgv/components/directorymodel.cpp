@@ -4,7 +4,7 @@ DirectoryModel::DirectoryModel(QObject *parent) :
     QObject(parent),
     fileListSource(SOURCE_DIRECTORY)
 {
-    scaler = new Scaler(&cache);
+    scaler = new Scaler(&scaledCache);
 
     connect(&dirManager, &DirectoryManager::fileRemoved,  this, &DirectoryModel::onFileRemoved);
     connect(&dirManager, &DirectoryManager::fileAdded,    this, &DirectoryModel::onFileAdded);
@@ -16,8 +16,16 @@ DirectoryModel::DirectoryModel(QObject *parent) :
 
     connect(&dirManager, &DirectoryManager::loaded, this, &DirectoryModel::loaded);
     connect(&dirManager, &DirectoryManager::sortingChanged, this, &DirectoryModel::onSortingChanged);
+    connect(&dirManager, &DirectoryManager::listChanged, this, &DirectoryModel::listChanged);
     connect(&loader, &Loader::loadFinished, this, &DirectoryModel::onImageReady);
     connect(&loader, &Loader::loadFailed, this, &DirectoryModel::loadFailed);
+    connect(&loader, &Loader::exifLoaded, this, &DirectoryModel::onExifLoaded);
+    connect(&loader, &Loader::fullResolutionLoaded, this, &DirectoryModel::onFullResolutionLoaded);
+
+    connect(&fileOperator, &FileOperator::taskFinished, this, &DirectoryModel::onFileOperationFinished);
+    connect(&fileOperator, &FileOperator::progress, this, &DirectoryModel::fileOperationsProgress);
+    connect(&fileOperator, &FileOperator::finished, this, &DirectoryModel::fileOperationsFinished);
+    connect(&saver, &Saver::saveFinished, this, &DirectoryModel::onSaveFinished);
 }
 
 DirectoryModel::~DirectoryModel() {
@@ -49,7 +57,7 @@ SortingMode DirectoryModel::sortingMode() const {
     return dirManager.sortingMode();
 }
 
-const FSEntry &DirectoryModel::fileEntryAt(int index) const {
+FSEntry DirectoryModel::fileEntryAt(int index) const {
     return dirManager.fileEntryAt(index);
 }
 
@@ -61,6 +69,10 @@ QString DirectoryModel::filePathAt(int index) const {
     return dirManager.filePathAt(index);
 }
 
+QStringList DirectoryModel::fileList() const {
+    return dirManager.fileList();
+}
+
 QString DirectoryModel::dirNameAt(int index) const {
     return dirManager.dirNameAt(index);
 }
@@ -172,29 +184,49 @@ void DirectoryModel::moveFileTo(const QString &srcFile, const QString &destDirPa
             dirManager.removeFileEntry(srcFile);
     }
 }
+
+// async; results come in via onFileOperationFinished()
+void DirectoryModel::startFileOperations(const QList<FileOpTask> &tasks) {
+    fileOperator.start(tasks);
+}
+
+void DirectoryModel::cancelFileOperations() {
+    fileOperator.cancel();
+}
+
+bool DirectoryModel::fileOperationsBusy() const {
+    return fileOperator.isBusy();
+}
+
+void DirectoryModel::onFileOperationFinished(FileOpTask task) {
+    if(task.move && task.result == FileOpResult::SUCCESS) {
+        if(task.destDirPath != this->directoryPath())
+            dirManager.removeFileEntry(task.srcPath);
+    }
+}
 // -----------------------------------------------------------------------------
 bool DirectoryModel::setDirectory(QString path) {
     cache.clear();
+    scaledCache.clear();
     return dirManager.setDirectory(path);
 }
 
 void DirectoryModel::unload(int index) {
     QString filePath = this->filePathAt(index);
     cache.remove(filePath);
+    scaledCache.remove(filePath);
 }
 
 void DirectoryModel::unload(QString filePath) {
     cache.remove(filePath);
+    scaledCache.remove(filePath);
 }
 
-void DirectoryModel::unloadExcept(QString filePath, bool keepNearby) {
-    QList<QString> list;
+void DirectoryModel::unloadExcept(QString filePath, QStringList keep) {
+    QList<QString> list = keep;
     list << filePath;
-    if(keepNearby)  {
-        list << prevOf(filePath);
-        list << nextOf(filePath);
-    }
     cache.trimTo(list);
+    scaledCache.trimTo(list);
 }
 
 bool DirectoryModel::loaderBusy() const {
@@ -207,6 +239,7 @@ void DirectoryModel::onImageReady(std::shared_ptr<Image> img, const QString &pat
         return;
     }
     cache.remove(path);
+    scaledCache.remove(path);
     cache.insert(img);
     emit imageReady(img, path);
 }
@@ -215,16 +248,53 @@ bool DirectoryModel::saveFile(const QString &filePath) {
     return saveFile(filePath, filePath);
 }
 
+// Only queues the save; the list is updated once the file is written (onSaveFinished)
 bool DirectoryModel::saveFile(const QString &filePath, const QString &destPath) {
     if(!containsFile(filePath) || !cache.contains(filePath))
         return false;
     auto img = cache.get(filePath);
-    if(img->save(destPath)) {
-        if(filePath == destPath) { // replace
-            dirManager.updateFileEntry(destPath);
-            emit fileModified(destPath);
-        } else { // manually add if we are saving to the same dir
-            QFileInfo fiSrc(filePath);
+    if(img->type() == STATIC) {
+        auto imgStatic = dynamic_cast<ImageStatic*>(img.get());
+        int quality = ImageLib::defaultSaveQuality(QFileInfo(destPath).suffix());
+        // unedited and never fully decoded: the file has the same pixels,
+        // leave the decode to the saver
+        if(imgStatic->isDownscaled()) {
+            saver.reencode(filePath, destPath, quality);
+            return true;
+        }
+        auto image = imgStatic->commitEdits();
+        if(!image || image->isNull())
+            return false;
+        saver.save(filePath, destPath, image, quality);
+        return true;
+    }
+    if(img->type() == ANIMATED) {
+        saver.copy(filePath, destPath);
+        return true;
+    }
+    return false;
+}
+
+bool DirectoryModel::saveBusy() const {
+    return saver.isBusy();
+}
+
+int DirectoryModel::pendingSaves() const {
+    return saver.pendingCount();
+}
+
+// the directory may be a different one by now
+void DirectoryModel::onSaveFinished(QString sourcePath, QString destPath, bool success) {
+    if(success) {
+        if(sourcePath == destPath) { // replace
+            if(cache.contains(destPath))
+                cache.get(destPath)->refreshFileInfo();
+            if(dirManager.containsFile(destPath)) {
+                dirManager.updateFileEntry(destPath);
+                emit fileModified(destPath);
+            }
+        } else if(dirManager.containsFile(sourcePath)) { // manually add if we are saving to the same dir
+            QFileInfo fiSrc(sourcePath);
             QFileInfo fiDest(destPath);
             // handle same dir
             if(fiSrc.absolutePath() == fiDest.absolutePath()) {
@@ -233,9 +303,8 @@ bool DirectoryModel::saveFile(const QString &filePath, const QString &destPath)
                     emit fileModified(destPath);
             }
         }
-        return true;
     }
-    return false;
+    emit saveFinished(sourcePath, destPath, success);
 }
 
 // dirManager events
@@ -295,6 +364,8 @@ std::shared_ptr<Image> DirectoryModel::getImage(QString filePath) {
 
 void DirectoryModel::updateImage(QString filePath, std::shared_ptr<Image> img) {
     if(containsFile(filePath) /*& cache.contains(filePath)*/) {
+        // contents changed (edit / discard), old renditions are stale
+        scaledCache.remove(filePath);
         if(!cache.contains(filePath)) {
             cache.insert(img);
         } else {
@@ -308,6 +379,7 @@ void DirectoryModel::load(QString filePath, bool asyncHint) {
     if(!containsFile(filePath) || loader.isLoading(filePath))
         return;
     if(!cache.contains(filePath)) {
+        perfCount("image cache miss");
         if(asyncHint) {
             loader.loadAsyncPriority(filePath);
         } else {
@@ -320,6 +392,7 @@ void DirectoryModel::load(QString filePath, bool asyncHint) {
             }
         }
     } else {
+        perfCount("image cache hit");
         emit imageReady(cache.get(filePath), filePath);
     }
 }
@@ -327,6 +400,7 @@ void DirectoryModel::load(QString filePath, bool asyncHint) {
 void DirectoryModel::reload(QString filePath) {
     if(cache.contains(filePath)) {
         cache.remove(filePath);
+        scaledCache.remove(filePath);
         dirManager.updateFileEntry(filePath);
         load(filePath, false);
     }
@@ -336,3 +410,36 @@ void DirectoryModel::preload(QString filePath) {
     if(containsFile(filePath) && !cache.contains(filePath))
         loader.loadAsync(filePath);
 }
+
+// async; result comes via exifTagsReady()
+void DirectoryModel::loadExifTags(QString filePath) {
+    loader.loadExifAsync(filePath);
+}
+
+// for images that were decoded at display size
+void DirectoryModel::loadFullResolution(QString filePath) {
+    loadFullResolution(cache.get(filePath));
+}
+
+// also for images that are not (or no longer) cached
+void DirectoryModel::loadFullResolution(std::shared_ptr<Image> img) {
+    if(img && img->isDownscaled())
+        loader.loadFullResolutionAsync(img);
+}
+
+void DirectoryModel::setDisplaySize(QSize size) {
+    loader.setDisplaySize(size);
+}
+
+void DirectoryModel::onFullResolutionLoaded(QString filePath) {
+    // renditions made from the reduced image
+    scaledCache.remove(filePath);
+    emit fullResolutionReady(filePath);
+}
+
+void DirectoryModel::onExifLoaded(QString filePath, QMap<QString, QString> tags) {
+    auto img = cache.get(filePath);
+    if(img && !img->exifTagsLoaded())
+        img->setExifTags(tags);
+    emit exifTagsReady(filePath, tags);
+}
@@ -5,6 +5,8 @@
 #include "directorymanager/directorymanager.h"
 #include "scaler/scaler.h"
 #include "loader/loader.h"
+#include "fileoperator/fileoperator.h"
+#include "saver/saver.h"
 #include "utils/fileoperations.h"
 
 class DirectoryModel : public QObject {
@@ -17,6 +19,10 @@ public:
 
     void load(QString filePath, bool asyncHint);
     void preload(QString filePath);
+    void loadExifTags(QString filePath);
+    void loadFullResolution(QString filePath);
+    void loadFullResolution(std::shared_ptr<Image> img);
+    void setDisplaySize(QSize size);
 
     int fileCount() const;
     int dirCount() const;
@@ -37,6 +43,9 @@ public:
     void renameEntry(const QString &oldFilePath, const QString &newName, bool force, FileOpResult &result);
     void removeFile(const QString &filePath, bool trash, FileOpResult &result);
     void removeDir(const QString &dirPath, bool trash, bool recursive, FileOpResult &result);
+    void startFileOperations(const QList<FileOpTask> &tasks);
+    void cancelFileOperations();
+    bool fileOperationsBusy() const;
 
     bool setDirectory(QString);
 
@@ -58,8 +67,9 @@ public:
     bool isLoaded(QString filePath) const;
     void reload(QString filePath);
     QString filePathAt(int index) const;
-    void unloadExcept(QString filePath, bool keepNearby);
-    const FSEntry &fileEntryAt(int index) const;
+    QStringList fileList() const;
+    void unloadExcept(QString filePath, QStringList keep);
+    FSEntry fileEntryAt(int index) const;
 
     int totalCount() const;
     QString dirNameAt(int index) const;
@@ -69,6 +79,8 @@ public:
 
     bool saveFile(const QString &filePath);
     bool saveFile(const QString &filePath, const QString &destPath);
+    bool saveBusy() const;
+    int pendingSaves() const;
 
     bool containsDir(QString dirPath) const;
     FileListSource source();
@@ -83,14 +95,23 @@ signals:
     void loaded(QString filePath);
     void loadFailed(const QString &path);
     void sortingChanged(SortingMode);
+    void listChanged();
     void indexChanged(int oldIndex, int index);
     void imageReady(std::shared_ptr<Image> img, const QString&);
     void imageUpdated(QString filePath);
+    void exifTagsReady(QString filePath, QMap<QString, QString> tags);
+    void fullResolutionReady(QString filePath);
+    void fileOperationsProgress(int done, int total, qint64 bytesPerSecond);
+    void fileOperationsFinished(int succeeded, int failed, bool canceled, FileOpTask firstFailed);
+    void saveFinished(QString sourcePath, QString destPath, bool success);
 
 private:
     DirectoryManager dirManager;
     Loader loader;
     Cache cache;
+    ScaledCache scaledCache;
+    FileOperator fileOperator;
+    Saver saver;
     FileListSource fileListSource;
 
 private slots:
@@ -100,4 +121,8 @@ private slots:
     void onFileRemoved(QString filePath, int index);
     void onFileRenamed(QString fromPath, int indexFrom, QString toPath, int indexTo);
     void onFileModified(QString filePath);
+    void onFileOperationFinished(FileOpTask task);
+    void onSaveFinished(QString sourcePath, QString destPath, bool success);
+    void onExifLoaded(QString filePath, QMap<QString, QString> tags);
+    void onFullResolutionLoaded(QString filePath);
 };
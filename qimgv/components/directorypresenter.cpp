@@ -24,8 +24,8 @@ void DirectoryPresenter::setView(std::shared_ptr<IDirectoryView> _view) {
         view->populate(mShowDirs ? model->totalCount() : model->fileCount());
     connect(dynamic_cast<QObject *>(view.get()), SIGNAL(itemActivated(int)),
             this, SLOT(onItemActivated(int)));
-    connect(dynamic_cast<QObject *>(view.get()), SIGNAL(thumbnailsRequested(QList<int>, int, bool, bool)),
-            this, SLOT(generateThumbnails(QList<int>, int, bool, bool)));
+    connect(dynamic_cast<QObject *>(view.get()), SIGNAL(thumbnailsRequested(QList<int>, int, bool, bool, int)),
+            this, SLOT(generateThumbnails(QList<int>, int, bool, bool, int)));
     connect(dynamic_cast<QObject *>(view.get()), SIGNAL(draggedOut()),
             this, SLOT(onDraggedOut()));
     connect(dynamic_cast<QObject *>(view.get()), SIGNAL(draggedOver(int)),
@@ -176,16 +176,18 @@ QList<QString> DirectoryPresenter::selectedPaths() const {
     return paths;
 }
 
-void DirectoryPresenter::generateThumbnails(QList<int> indexes, int size, bool crop, bool force) {
+// the first visibleCount indexes are on screen, the rest are around it
+void DirectoryPresenter::generateThumbnails(QList<int> indexes, int size, bool crop, bool force, int visibleCount) {
     if(!view || !model)
         return;
     thumbnailer.clearTasks();
     if(!mShowDirs) {
-        for(int i : indexes)
-            thumbnailer.getThumbnailAsync(model->filePathAt(i), size, crop, force);
+        for(int n = 0; n < indexes.count(); n++)
+            thumbnailer.getThumbnailAsync(model->filePathAt(indexes.at(n)), size, crop, force, n < visibleCount);
         return;
     }
-    for(int i : indexes) {
+    for(int n = 0; n < indexes.count(); n++) {
+        int i = indexes.at(n);
         if(i < model->dirCount()) {
             // tmp ------------------------------------------------------------
             // gen thumb for a directory
@@ -210,7 +212,7 @@ void DirectoryPresenter::generateThumbnails(QList<int> indexes, int size, bool c
             view->setThumbnail(i, thumb);
         } else {
             QString path = model->filePathAt(i - model->dirCount());
-            thumbnailer.getThumbnailAsync(path, size, crop, force);
+            thumbnailer.getThumbnailAsync(path, size, crop, force, n < visibleCount);
         }
     }
 }
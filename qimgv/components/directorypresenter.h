@@ -49,7 +49,7 @@ public slots:
     void reloadModel();
 
 private slots:
-    void generateThumbnails(QList<int>, int, bool, bool);
+    void generateThumbnails(QList<int>, int, bool, bool, int);
     void onThumbnailReady(std::shared_ptr<Thumbnail> thumb, QString filePath);
     void populateView();
     void onItemActivated(int absoluteIndex);
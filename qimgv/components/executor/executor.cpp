@@ -0,0 +1,171 @@
+#include "executor.h"
+
+Executor *Executor::getInstance() {
+    static Executor instance;
+    return &instance;
+}
+
+Executor::Executor()
+    : lowPriorityRunning(0),
+      shutdown(false)
+{
+    int count = qMax(2, QThread::idealThreadCount());
+    for(int i = 0; i < count; i++) {
+        auto worker = QThread::create([this]() { work(); });
+        worker->setObjectName("Executor worker " + QString::number(i));
+        worker->start();
+        workers.push_back(worker);
+    }
+}
+
+Executor::~Executor() {
+    mutex.lock();
+    shutdown = true;
+    wakeup.wakeAll();
+    mutex.unlock();
+    for(auto worker : workers) {
+        worker->wait();
+        delete worker;
+    }
+}
+
+int Executor::threadCount() const {
+    return static_cast<int>(workers.size());
+}
+
+void Executor::start(QRunnable *task, Priority priority, TaskQueue *queue) {
+    QMutexLocker lock(&mutex);
+    queues[priority].push_back({ task, queue });
+    queue->queued++;
+    wakeup.wakeOne();
+}
+
+bool Executor::tryTake(QRunnable *task, TaskQueue *queue) {
+    QMutexLocker lock(&mutex);
+    for(auto &q : queues) {
+        for(auto it = q.begin(); it != q.end(); ++it) {
+            if(it->task == task && it->queue == queue) {
+                q.erase(it);
+                queue->queued--;
+                taskDone.wakeAll();
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+void Executor::clear(TaskQueue *queue) {
+    std::vector<QRunnable*> removed;
+    mutex.lock();
+    for(auto &q : queues) {
+        for(auto it = q.begin(); it != q.end();) {
+            if(it->queue == queue) {
+                removed.push_back(it->task);
+                it = q.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    queue->queued = 0;
+    taskDone.wakeAll();
+    mutex.unlock();
+    // destructors may do anything; not under the lock
+    for(auto task : removed)
+        if(task->autoDelete())
+            delete task;
+}
+
+void Executor::waitForDone(TaskQueue *queue) {
+    QMutexLocker lock(&mutex);
+    while(queue->queued || queue->running)
+        taskDone.wait(&mutex);
+}
+
+void Executor::work() {
+    QMutexLocker lock(&mutex);
+    forever {
+        Entry entry = { nullptr, nullptr };
+        Priority priority = BACKGROUND;
+        while(!shutdown && !takeNext(entry, priority))
+            wakeup.wait(&mutex);
+        if(shutdown)
+            return;
+        lock.unlock();
+
+        // same as QThreadPool: the task may delete itself or be reused
+        bool autoDelete = entry.task->autoDelete();
+        entry.task->run();
+        if(autoDelete)
+            delete entry.task;
+
+        lock.relock();
+        entry.queue->running--;
+        if(priority >= PRELOAD)
+            lowPriorityRunning--;
+        taskDone.wakeAll();
+        // a limit may have been lifted; let the others look again
+        wakeup.wakeAll();
+    }
+}
+
+bool Executor::takeNext(Entry &entry, Priority &priority) {
+    int lowPriorityLimit = qMax(1, threadCount() - 1);
+    for(int p = 0; p < PRIORITY_COUNT; p++) {
+        if(p >= PRELOAD && lowPriorityRunning >= lowPriorityLimit)
+            return false;
+        auto &q = queues[p];
+        for(auto it = q.begin(); it != q.end(); ++it) {
+            TaskQueue *queue = it->queue;
+            if(queue->maxRunning && queue->running >= queue->maxRunning)
+                continue;
+            entry = *it;
+            priority = static_cast<Priority>(p);
+            q.erase(it);
+            queue->queued--;
+            queue->running++;
+            if(p >= PRELOAD)
+                lowPriorityRunning++;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ##############################################################
+
+TaskQueue::TaskQueue(int _maxRunning)
+    : executor(Executor::getInstance()),
+      maxRunning(_maxRunning),
+      queued(0),
+      running(0)
+{
+}
+
+TaskQueue::~TaskQueue() {
+    clear();
+    waitForDone();
+}
+
+void TaskQueue::start(QRunnable *task, Executor::Priority priority) {
+    executor->start(task, priority, this);
+}
+
+bool TaskQueue::tryTake(QRunnable *task) {
+    return executor->tryTake(task, this);
+}
+
+void TaskQueue::clear() {
+    executor->clear(this);
+}
+
+void TaskQueue::waitForDone() {
+    executor->waitForDone(this);
+}
+
+void TaskQueue::setMaxRunning(int count) {
+    QMutexLocker lock(&executor->mutex);
+    maxRunning = count;
+    executor->wakeup.wakeAll();
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <QRunnable>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QDebug>
+#include <deque>
+#include <vector>
+
+class TaskQueue;
+
+// One set of worker threads for all the cpu-heavy background work
+// (decoding, scaling, thumbnails), so the components don't compete
+// with each other for cores.
+//
+// Every task goes into a priority class. A free worker takes the oldest
+// task from the most important class that has one; so a thumbnail storm
+// in the folder view can't hold up decoding of the current image.
+// On top of that, everything below SCALING may occupy at most all
+// workers but one; the last one is always free for the current image.
+//
+// Tasks are never interrupted once started.
+// Components don't use this directly, but through a TaskQueue.
+class Executor {
+public:
+    enum Priority {
+        CURRENT_IMAGE,
+        SCALING,
+        PRELOAD,
+        THUMBNAIL_VISIBLE,
+        THUMBNAIL_OFFSCREEN,
+        BACKGROUND,
+        PRIORITY_COUNT
+    };
+
+    static Executor *getInstance();
+    ~Executor();
+    int threadCount() const;
+
+private:
+    friend class TaskQueue;
+    struct Entry {
+        QRunnable *task;
+        TaskQueue *queue;
+    };
+
+    Executor();
+    void start(QRunnable *task, Priority priority, TaskQueue *queue);
+    bool tryTake(QRunnable *task, TaskQueue *queue);
+    void clear(TaskQueue *queue);
+    void waitForDone(TaskQueue *queue);
+    void work();
+    // call with mutex locked
+    bool takeNext(Entry &entry, Priority &priority);
+
+    std::vector<QThread*> workers;
+    QMutex mutex;
+    QWaitCondition wakeup, taskDone;
+    std::deque<Entry> queues[PRIORITY_COUNT];
+    int lowPriorityRunning;
+    bool shutdown;
+};
+
+// A component's view of the Executor, used like a QThreadPool:
+// clear() and waitForDone() only touch tasks started from here.
+// maxRunning limits how many of them run at once (0 = no limit).
+class TaskQueue {
+public:
+    explicit TaskQueue(int _maxRunning = 0);
+    // drops whatever did not start yet and waits for the rest
+    ~TaskQueue();
+
+    void start(QRunnable *task, Executor::Priority priority);
+    // removes a task that did not start yet; the caller owns it after that
+    bool tryTake(QRunnable *task);
+    // removes every task that did not start yet; deletes the autoDelete ones
+    void clear();
+    void waitForDone();
+    void setMaxRunning(int count);
+
+private:
+    friend class Executor;
+    Executor *executor;
+    // guarded by executor->mutex
+    int maxRunning, queued, running;
+};
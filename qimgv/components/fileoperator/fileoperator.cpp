@@ -0,0 +1,75 @@
+#include "fileoperator.h"
+
+FileOperator::FileOperator(QObject *parent)
+    : QObject(parent),
+      abortFlag(0),
+      total(0),
+      done(0),
+      succeeded(0),
+      failed(0),
+      bytesDone(0)
+{
+    pool = new QThreadPool(this);
+    // a few parallel streams help on ssd / network storage
+    // more than that just makes spinning disks seek
+    pool->setMaxThreadCount(qBound(1, QThread::idealThreadCount(), 4));
+}
+
+FileOperator::~FileOperator() {
+    abortFlag.storeRelease(1);
+    pool->clear();
+    pool->waitForDone();
+}
+
+void FileOperator::start(const QList<FileOpTask> &tasks) {
+    if(tasks.isEmpty())
+        return;
+    if(!isBusy()) {
+        abortFlag.storeRelease(0);
+        total = done = succeeded = failed = 0;
+        bytesDone = 0;
+        firstFailed = FileOpTask();
+        batchTimer.start();
+        progressTimer.start();
+    }
+    total += tasks.count();
+    for(auto task : tasks) {
+        auto runnable = new FileOperatorRunnable(task, &abortFlag);
+        connect(runnable, &FileOperatorRunnable::finished, this, &FileOperator::onTaskFinished);
+        runnable->setAutoDelete(true);
+        pool->start(runnable);
+    }
+    emit progress(done, total, 0);
+}
+
+// queued tasks are skipped, running ones stop after the current chunk
+void FileOperator::cancel() {
+    if(isBusy())
+        abortFlag.storeRelease(1);
+}
+
+bool FileOperator::isBusy() const {
+    return done < total;
+}
+
+void FileOperator::onTaskFinished(FileOpTask task) {
+    done++;
+    if(task.result == FileOpResult::SUCCESS) {
+        succeeded++;
+        bytesDone += task.size;
+    } else if(task.result != FileOpResult::CANCELED) {
+        if(!failed)
+            firstFailed = task;
+        failed++;
+    }
+    emit taskFinished(task);
+    if(done == total) {
+        emit finished(succeeded, failed, abortFlag.loadAcquire(), firstFailed);
+        return;
+    }
+    if(progressTimer.elapsed() >= PROGRESS_INTERVAL) {
+        progressTimer.restart();
+        qint64 elapsed = qMax<qint64>(batchTimer.elapsed(), 1);
+        emit progress(done, total, bytesDone * 1000 / elapsed);
+    }
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QObject>
+#include <QThreadPool>
+#include <QThread>
+#include <QElapsedTimer>
+#include "fileoperatorrunnable.h"
+
+// Runs file copy / move tasks on a small pool of worker threads.
+// Conflicts must be resolved before submitting (see FileOpTask::force),
+// workers never ask anything.
+class FileOperator : public QObject {
+    Q_OBJECT
+public:
+    explicit FileOperator(QObject *parent = nullptr);
+    ~FileOperator();
+    // appends to the current batch if one is already running
+    void start(const QList<FileOpTask> &tasks);
+    void cancel();
+    bool isBusy() const;
+
+signals:
+    void taskFinished(FileOpTask task);
+    // throttled; bytesPerSecond is the average since batch start
+    void progress(int done, int total, qint64 bytesPerSecond);
+    // firstFailed is only meaningful when failed > 0
+    void finished(int succeeded, int failed, bool canceled, FileOpTask firstFailed);
+
+private:
+    QThreadPool *pool;
+    QAtomicInt abortFlag;
+    int total, done, succeeded, failed;
+    qint64 bytesDone;
+    FileOpTask firstFailed;
+    QElapsedTimer batchTimer, progressTimer;
+    const int PROGRESS_INTERVAL = 250; // ms
+
+private slots:
+    void onTaskFinished(FileOpTask task);
+};
@@ -0,0 +1,19 @@
+#include "fileoperatorrunnable.h"
+
+FileOperatorRunnable::FileOperatorRunnable(FileOpTask _task, const QAtomicInt *_abortFlag)
+    : task(_task),
+      abortFlag(_abortFlag)
+{
+}
+
+void FileOperatorRunnable::run() {
+    // canceled tasks still report back so the counters stay consistent
+    if(abortFlag->loadAcquire()) {
+        task.result = FileOpResult::CANCELED;
+    } else if(task.move) {
+        FileOperations::moveFileTo(task.srcPath, task.destDirPath, task.force, task.result, abortFlag);
+    } else {
+        FileOperations::copyFileTo(task.srcPath, task.destDirPath, task.force, task.result, abortFlag);
+    }
+    emit finished(task);
+}
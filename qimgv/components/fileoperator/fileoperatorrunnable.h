@@ -0,0 +1,20 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QAtomicInt>
+#include "fileoptask.h"
+
+class FileOperatorRunnable : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    FileOperatorRunnable(FileOpTask _task, const QAtomicInt *_abortFlag);
+    void run();
+
+private:
+    FileOpTask task;
+    const QAtomicInt *abortFlag;
+
+signals:
+    void finished(FileOpTask);
+};
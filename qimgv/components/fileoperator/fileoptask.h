@@ -0,0 +1,14 @@
+#pragma once
+
+#include <QString>
+#include "utils/fileoperations.h"
+
+// A single file copy / move handled by FileOperator
+struct FileOpTask {
+    QString srcPath;
+    QString destDirPath;
+    bool move = false;
+    bool force = false;
+    qint64 size = 0;
+    FileOpResult result = FileOpResult::NOTHING_TO_DO;
+};
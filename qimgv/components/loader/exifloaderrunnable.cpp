@@ -0,0 +1,8 @@
+#include "exifloaderrunnable.h"
+
+ExifLoaderRunnable::ExifLoaderRunnable(QString _path) : path(_path) {
+}
+
+void ExifLoaderRunnable::run() {
+    emit finished(path, DocumentInfo::readExifTags(path));
+}
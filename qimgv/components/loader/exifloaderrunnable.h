@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QMap>
+#include "sourcecontainers/documentinfo.h"
+
+class ExifLoaderRunnable: public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    ExifLoaderRunnable(QString _path);
+    void run();
+private:
+    QString path;
+signals:
+    void finished(QString, QMap<QString, QString>);
+};
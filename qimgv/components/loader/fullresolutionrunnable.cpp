@@ -0,0 +1,10 @@
+#include "fullresolutionrunnable.h"
+
+FullResolutionRunnable::FullResolutionRunnable(std::shared_ptr<Image> _image) : image(_image) {
+}
+
+void FullResolutionRunnable::run() {
+    // decodes the rest as a side effect
+    image->getImage();
+    emit finished(image->filePath());
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include "sourcecontainers/image.h"
+
+// Finishes decoding an image that was loaded downscaled
+class FullResolutionRunnable: public QObject, public QRunnable
+{
+    Q_OBJECT
+public:
+    FullResolutionRunnable(std::shared_ptr<Image> _image);
+    void run();
+private:
+    std::shared_ptr<Image> image;
+signals:
+    void finished(QString);
+};
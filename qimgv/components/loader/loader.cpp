@@ -1,13 +1,11 @@
 #include "loader.h"
 
 Loader::Loader() {
-    pool = new QThreadPool(this);
-    pool->setMaxThreadCount(2);
 }
 
 void Loader::clearTasks() {
     clearPool();
-    pool->waitForDone();
+    pool.waitForDone();
 }
 
 bool Loader::isBusy() const {
@@ -19,29 +17,58 @@ bool Loader::isLoading(QString path) {
 }
 
 std::shared_ptr<Image> Loader::load(QString path) {
-    return ImageFactory::createImage(path);
+    // exif is read later in background
+    return ImageFactory::createImage(path, displaySize);
 }
 
 // clears all buffered tasks before loading
 void Loader::loadAsyncPriority(QString path) {
     clearPool();
-    doLoadAsync(path, 1);
+    doLoadAsync(path, Executor::CURRENT_IMAGE);
 }
 
 void Loader::loadAsync(QString path) {
-    doLoadAsync(path, 0);
+    // file is read by the time a thread gets to it
+    if(!tasks.contains(path))
+        MappedFile::prefetch(path);
+    doLoadAsync(path, Executor::PRELOAD);
 }
 
-void Loader::doLoadAsync(QString path, int priority) {
+// for images that were loaded without exif (synchronously)
+void Loader::loadExifAsync(QString path) {
+    auto runnable = new ExifLoaderRunnable(path);
+    runnable->setAutoDelete(true);
+    connect(runnable, &ExifLoaderRunnable::finished, this, &Loader::exifLoaded);
+    pool.start(runnable, Executor::CURRENT_IMAGE);
+}
+
+void Loader::loadFullResolutionAsync(std::shared_ptr<Image> image) {
+    if(!image || fullResolutionTasks.contains(image->filePath()))
+        return;
+    fullResolutionTasks.insert(image->filePath());
+    auto runnable = new FullResolutionRunnable(image);
+    runnable->setAutoDelete(true);
+    connect(runnable, &FullResolutionRunnable::finished, this, [this](QString path) {
+        fullResolutionTasks.remove(path);
+        emit fullResolutionLoaded(path);
+    });
+    pool.start(runnable, Executor::CURRENT_IMAGE);
+}
+
+void Loader::setDisplaySize(QSize size) {
+    displaySize = size;
+}
+
+void Loader::doLoadAsync(QString path, Executor::Priority priority) {
     if(tasks.contains(path)) {
         return;
     }
 
-    auto runnable = new LoaderRunnable(path);
+    auto runnable = new LoaderRunnable(path, displaySize);
     runnable->setAutoDelete(false);
     tasks.insert(path, runnable);
     connect(runnable, &LoaderRunnable::finished, this, &Loader::onLoadFinished, Qt::UniqueConnection);
-    pool->start(runnable, priority);
+    pool.start(runnable, priority);
 }
 
 void Loader::onLoadFinished(std::shared_ptr<Image> image, const QString &path) {
@@ -57,7 +84,7 @@ void Loader::clearPool() {
     QHashIterator<QString, LoaderRunnable*> i(tasks);
     while (i.hasNext()) {
         i.next();
-        if(pool->tryTake(i.value())) {
+        if(pool.tryTake(i.value())) {
             delete tasks.take(i.key());
         }
     }
@@ -1,8 +1,11 @@
 #pragma once
 
-#include <QThreadPool>
+#include <QSet>
+#include "components/executor/executor.h"
 #include "components/cache/thumbnailcache.h"
 #include "loaderrunnable.h"
+#include "exifloaderrunnable.h"
+#include "fullresolutionrunnable.h"
 
 class Loader : public QObject {
     Q_OBJECT
@@ -11,19 +14,27 @@ public:
     std::shared_ptr<Image> load(QString path);
     void loadAsyncPriority(QString path);
     void loadAsync(QString path);
+    void loadExifAsync(QString path);
+    void loadFullResolutionAsync(std::shared_ptr<Image> image);
+    // images are decoded only as large as needed for this; empty = full size
+    void setDisplaySize(QSize size);
 
     void clearTasks();
     bool isBusy() const;
     bool isLoading(QString path);
 private:
     QHash<QString, LoaderRunnable*> tasks;
-    QThreadPool *pool;    
+    QSet<QString> fullResolutionTasks;
+    QSize displaySize;
+    TaskQueue pool;
     void clearPool();
-    void doLoadAsync(QString path, int priority);
+    void doLoadAsync(QString path, Executor::Priority priority);
 
 signals:
     void loadFinished(std::shared_ptr<Image>, const QString &path);
     void loadFailed(const QString &path);
+    void exifLoaded(QString path, QMap<QString, QString> tags);
+    void fullResolutionLoaded(QString path);
 
 private slots:
     void onLoadFinished(std::shared_ptr<Image>, const QString&);
@@ -1,14 +1,12 @@
 #include "loaderrunnable.h"
 
-#include <QElapsedTimer>
-
-LoaderRunnable::LoaderRunnable(QString _path) : path(_path) {
+LoaderRunnable::LoaderRunnable(QString _path, QSize _displaySize) : path(_path), displaySize(_displaySize) {
 }
 
 void LoaderRunnable::run() {
-    //QElapsedTimer t;
-    //t.start();
-    auto image = ImageFactory::createImage(path);
-    //qDebug() << "L: " << t.elapsed();
+    auto image = ImageFactory::createImage(path, displaySize);
+    // while we are here, so the gui thread doesn't have to
+    if(image)
+        image->loadExifTags();
     emit finished(image, path);
 }
@@ -8,10 +8,11 @@ class LoaderRunnable: public QObject, public QRunnable
 {
     Q_OBJECT
 public:
-    LoaderRunnable(QString _path);
+    LoaderRunnable(QString _path, QSize _displaySize);
     void run();
 private:
     QString path;
+    QSize displaySize;
 signals:
     void finished(std::shared_ptr<Image>, QString);
     void failed(QString);
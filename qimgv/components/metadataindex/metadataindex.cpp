@@ -0,0 +1,145 @@
+#include "metadataindex.h"
+
+#define INDEX_MAGIC         0x716d6978 // "qmix"
+#define INDEX_VERSION       1
+// records kept in memory before they are appended to the file
+#define FLUSH_THRESHOLD     256
+// rewrite the log when it has this many stale records on top of the live ones
+#define COMPACT_MIN_STALE   4096
+
+bool MetadataFilter::isActive() const {
+    return minSize.width() > 0 || minSize.height() > 0 || (types & FILTER_TYPE_ALL) != FILTER_TYPE_ALL;
+}
+
+bool MetadataFilter::accepts(DocumentType type, int width, int height) const {
+    if(type != DocumentType::NONE && !(types & (1 << type)))
+        return false;
+    // no size for videos; let them through
+    if(type != DocumentType::VIDEO && (width < minSize.width() || height < minSize.height()))
+        return false;
+    return true;
+}
+
+bool MetadataFilter::operator==(const MetadataFilter &other) const {
+    return minSize == other.minSize && types == other.types;
+}
+
+bool MetadataFilter::operator!=(const MetadataFilter &other) const {
+    return !(*this == other);
+}
+
+// ##############################################################
+
+MetadataIndex *MetadataIndex::getInstance() {
+    static MetadataIndex instance;
+    return &instance;
+}
+
+MetadataIndex::MetadataIndex()
+    : logRecords(0)
+{
+    indexPath = settings->tmpDir() + "metadata.idx";
+    load();
+}
+
+MetadataIndex::~MetadataIndex() {
+    flush();
+}
+
+bool MetadataIndex::find(const QString &path, quint64 size, qint64 modifyTime, FileMetadata &metadata) const {
+    QReadLocker locker(&lock);
+    auto it = records.constFind(path);
+    if(it == records.constEnd() || it->size != size || it->modifyTime != modifyTime)
+        return false;
+    metadata = it->metadata;
+    return true;
+}
+
+void MetadataIndex::insert(const QString &path, quint64 size, qint64 modifyTime, const FileMetadata &metadata) {
+    Record record = { size, modifyTime, metadata };
+    size_t pendingCount;
+    lock.lockForWrite();
+    records.insert(path, record);
+    pending.emplace_back(path, record);
+    pendingCount = pending.size();
+    lock.unlock();
+    if(pendingCount >= FLUSH_THRESHOLD)
+        flush();
+}
+
+void MetadataIndex::flush() {
+    QMutexLocker fileLocker(&fileMutex);
+    std::vector<std::pair<QString, Record>> batch;
+    lock.lockForWrite();
+    batch.swap(pending);
+    lock.unlock();
+    if(batch.empty())
+        return;
+    QFile file(indexPath);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Append)) {
+        qDebug() << "[MetadataIndex] could not write" << indexPath;
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    for(auto &item : batch)
+        writeRecord(out, item.first, item.second);
+    logRecords += static_cast<int>(batch.size());
+}
+
+void MetadataIndex::writeRecord(QDataStream &out, const QString &path, const Record &record) {
+    auto &m = record.metadata;
+    out << path << record.size << record.modifyTime << m.captureTime
+        << qint32(m.width) << qint32(m.height) << quint8(m.orientation) << quint8(m.type);
+}
+
+void MetadataIndex::load() {
+    QFile file(indexPath);
+    if(file.open(QIODevice::ReadOnly)) {
+        QDataStream in(&file);
+        in.setVersion(QDataStream::Qt_5_12);
+        quint32 magic;
+        qint32 version;
+        in >> magic >> version;
+        if(magic == INDEX_MAGIC && version == INDEX_VERSION) {
+            while(!in.atEnd()) {
+                QString path;
+                Record record;
+                qint32 width, height;
+                quint8 orientation, type;
+                in >> path >> record.size >> record.modifyTime >> record.metadata.captureTime
+                   >> width >> height >> orientation >> type;
+                // a record cut short by a crash; everything before it is fine
+                if(in.status() != QDataStream::Ok)
+                    break;
+                record.metadata.width = width;
+                record.metadata.height = height;
+                record.metadata.orientation = orientation;
+                record.metadata.type = type <= DocumentType::VIDEO ? static_cast<DocumentType>(type) : DocumentType::NONE;
+                records.insert(path, record);
+                logRecords++;
+            }
+            if(in.status() == QDataStream::Ok && logRecords - records.size() < COMPACT_MIN_STALE)
+                return;
+        }
+    }
+    file.close();
+    // missing, damaged or full of stale records
+    compact();
+}
+
+// call from the constructor only
+void MetadataIndex::compact() {
+    QSaveFile file(indexPath);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "[MetadataIndex] could not write" << indexPath;
+        return;
+    }
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_5_12);
+    out << quint32(INDEX_MAGIC) << qint32(INDEX_VERSION);
+    for(auto it = records.constBegin(); it != records.constEnd(); ++it)
+        writeRecord(out, it.key(), it.value());
+    if(file.commit())
+        logRecords = static_cast<int>(records.size());
+}
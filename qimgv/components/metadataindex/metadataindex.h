@@ -0,0 +1,82 @@
+#pragma once
+
+#include <QString>
+#include <QHash>
+#include <QFile>
+#include <QSaveFile>
+#include <QDataStream>
+#include <QReadWriteLock>
+#include <QMutex>
+#include <QDebug>
+#include <vector>
+#include "sourcecontainers/documentinfo.h"
+#include "settings.h"
+
+// What the listing needs to know about a file beyond name / size / time.
+struct FileMetadata {
+    // DateTimeOriginal as ms from julian day 0, -1 if there is none.
+    // Camera clocks have no timezone, so neither does this; only good for ordering.
+    qint64 captureTime = -1;
+    // as displayed (exif orientation applied); 0 when unknown
+    int width = 0;
+    int height = 0;
+    // QImageIOHandler::Transformation
+    int orientation = 0;
+    DocumentType type = DocumentType::NONE;
+};
+
+// Bitmask over DocumentType
+enum MetadataTypeFilter {
+    FILTER_TYPE_STATIC   = 1 << DocumentType::STATIC,
+    FILTER_TYPE_ANIMATED = 1 << DocumentType::ANIMATED,
+    FILTER_TYPE_VIDEO    = 1 << DocumentType::VIDEO,
+    FILTER_TYPE_ALL      = FILTER_TYPE_STATIC | FILTER_TYPE_ANIMATED | FILTER_TYPE_VIDEO
+};
+
+struct MetadataFilter {
+    QSize minSize;  // as displayed; 0 in either dimension means any
+    int types = FILTER_TYPE_ALL;
+
+    bool isActive() const;
+    bool accepts(DocumentType type, int width, int height) const;
+    bool operator==(const MetadataFilter &other) const;
+    bool operator!=(const MetadataFilter &other) const;
+};
+
+// Persistent per-user store of FileMetadata, keyed by path and
+// invalidated by file size / modification time.
+//
+// Everything lives in memory; the file on disk is an append-only log
+// of records (the last one for a path wins), compacted on load when
+// it has grown too much. Safe to use from any thread.
+class MetadataIndex {
+public:
+    static MetadataIndex *getInstance();
+    ~MetadataIndex();
+
+    // false if there is nothing, or only a record for a different version of the file
+    bool find(const QString &path, quint64 size, qint64 modifyTime, FileMetadata &metadata) const;
+    void insert(const QString &path, quint64 size, qint64 modifyTime, const FileMetadata &metadata);
+    // write out pending records
+    void flush();
+
+private:
+    struct Record {
+        quint64 size;
+        qint64 modifyTime; // file_time_type ticks
+        FileMetadata metadata;
+    };
+
+    MetadataIndex();
+    void load();
+    void compact();
+    static void writeRecord(QDataStream &out, const QString &path, const Record &record);
+
+    QString indexPath;
+    QHash<QString, Record> records;
+    mutable QReadWriteLock lock;
+    // not yet on disk
+    std::vector<std::pair<QString, Record>> pending;
+    QMutex fileMutex;
+    int logRecords;
+};
@@ -0,0 +1,230 @@
+#include "metadataindexer.h"
+
+// files per task; small enough for the list to fill in steadily
+#define INDEX_BATCH_SIZE    64
+// mostly waiting for the disk, more threads won't help
+#define INDEX_THREADS       2
+// how much to read looking for exif when the file could not be mapped
+#define EXIF_READ_LIMIT     (256 * 1024) // bytes
+
+namespace {
+
+// Just enough of TIFF / EXIF to get the capture date.
+// Files are untrusted: every read is bounds-checked.
+class TiffReader {
+public:
+    TiffReader(const uchar *_data, qint64 _size)
+        : data(_data), size(_size), little(_size >= 2 && _data[0] == 'I') { }
+
+    bool u16(qint64 pos, quint16 &value) const {
+        if(pos < 0 || pos + 2 > size)
+            return false;
+        value = little ? quint16(data[pos] | data[pos + 1] << 8)
+                       : quint16(data[pos] << 8 | data[pos + 1]);
+        return true;
+    }
+
+    bool u32(qint64 pos, quint32 &value) const {
+        quint16 a, b;
+        if(!u16(pos, a) || !u16(pos + 2, b))
+            return false;
+        value = little ? (quint32(b) << 16 | a) : (quint32(a) << 16 | b);
+        return true;
+    }
+
+    // position of the ifd entry for tag, or -1
+    qint64 findEntry(qint64 ifd, quint16 tag) const {
+        quint16 count, entryTag;
+        if(!u16(ifd, count))
+            return -1;
+        for(int i = 0; i < count; i++) {
+            qint64 entry = ifd + 2 + i * 12;
+            if(!u16(entry, entryTag))
+                return -1;
+            if(entryTag == tag)
+                return entry;
+        }
+        return -1;
+    }
+
+    quint32 offsetTag(qint64 ifd, quint16 tag) const {
+        quint32 value = 0;
+        qint64 entry = findEntry(ifd, tag);
+        if(entry >= 0)
+            u32(entry + 8, value);
+        return value;
+    }
+
+    QByteArray asciiTag(qint64 ifd, quint16 tag) const {
+        quint16 type;
+        quint32 count, offset;
+        qint64 entry = findEntry(ifd, tag);
+        if(entry < 0 || !u16(entry + 2, type) || type != 2 || !u32(entry + 4, count))
+            return QByteArray();
+        // only used for dates
+        if(count > 64)
+            return QByteArray();
+        qint64 pos = entry + 8;
+        if(count > 4) {
+            if(!u32(pos, offset))
+                return QByteArray();
+            pos = offset;
+        }
+        if(pos + count > size)
+            return QByteArray();
+        return QByteArray(reinterpret_cast<const char*>(data + pos), static_cast<int>(count));
+    }
+
+    bool isValid() const {
+        quint16 magic;
+        return size >= 8 && (data[0] == 'I' || data[0] == 'M') && data[0] == data[1] && u16(2, magic) && magic == 42;
+    }
+
+private:
+    const uchar *data;
+    qint64 size;
+    bool little;
+};
+
+// "YYYY:MM:DD HH:MM:SS"
+qint64 parseExifDate(const QByteArray &str) {
+    if(str.size() < 19)
+        return -1;
+    QDate date(str.mid(0, 4).toInt(), str.mid(5, 2).toInt(), str.mid(8, 2).toInt());
+    QTime time(str.mid(11, 2).toInt(), str.mid(14, 2).toInt(), str.mid(17, 2).toInt());
+    if(!date.isValid() || !time.isValid())
+        return -1;
+    return date.toJulianDay() * 86400000 + time.msecsSinceStartOfDay();
+}
+
+// the tiff structure holding exif: the whole file for tiff-based formats,
+// app1 segment contents for jpeg
+bool findTiffHeader(const uchar *data, qint64 size, qint64 &offset) {
+    if(TiffReader(data, size).isValid()) {
+        offset = 0;
+        return true;
+    }
+    if(size < 4 || data[0] != 0xFF || data[1] != 0xD8)
+        return false;
+    qint64 pos = 2;
+    while(pos + 4 <= size && data[pos] == 0xFF) {
+        uchar marker = data[pos + 1];
+        // padding, or a marker without payload
+        if(marker == 0xFF) {
+            pos++;
+            continue;
+        }
+        if(marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            pos += 2;
+            continue;
+        }
+        // image data starts; exif always comes before that
+        if(marker == 0xDA || marker == 0xD9)
+            return false;
+        qint64 length = data[pos + 2] << 8 | data[pos + 3];
+        if(marker == 0xE1 && length >= 16 && pos + 2 + length <= size &&
+           memcmp(data + pos + 4, "Exif\0\0", 6) == 0)
+        {
+            offset = pos + 10;
+            return true;
+        }
+        pos += 2 + length;
+    }
+    return false;
+}
+
+qint64 readCaptureTime(const QByteArray &head) {
+    auto data = reinterpret_cast<const uchar*>(head.constData());
+    qint64 offset;
+    if(!findTiffHeader(data, head.size(), offset))
+        return -1;
+    TiffReader tiff(data + offset, head.size() - offset);
+    if(!tiff.isValid())
+        return -1;
+    quint32 ifd0;
+    if(!tiff.u32(4, ifd0))
+        return -1;
+    qint64 captureTime = -1;
+    quint32 exifIfd = tiff.offsetTag(ifd0, 0x8769);
+    if(exifIfd)
+        captureTime = parseExifDate(tiff.asciiTag(exifIfd, 0x9003)); // DateTimeOriginal
+    if(captureTime < 0)
+        captureTime = parseExifDate(tiff.asciiTag(ifd0, 0x0132));    // DateTime
+    return captureTime;
+}
+
+}
+
+// ##############################################################
+
+MetadataIndexerRunnable::MetadataIndexerRunnable(QVector<MetadataRequest> _requests, int _generation)
+    : requests(_requests),
+      generation(_generation)
+{
+}
+
+void MetadataIndexerRunnable::run() {
+    auto index = MetadataIndex::getInstance();
+    QVector<MetadataResult> results;
+    results.reserve(requests.size());
+    for(auto &request : requests) {
+        MetadataResult result;
+        result.token = request.token;
+        if(!index->find(request.path, request.size, request.modifyTime, result.metadata)) {
+            result.metadata = MetadataIndexer::extract(request.path);
+            index->insert(request.path, request.size, request.modifyTime, result.metadata);
+        }
+        results.append(result);
+    }
+    emit finished(generation, results);
+}
+
+// ##############################################################
+
+MetadataIndexer::MetadataIndexer() {
+    pool.setMaxRunning(INDEX_THREADS);
+}
+
+MetadataIndexer::~MetadataIndexer() {
+    pool.clear();
+    pool.waitForDone();
+    MetadataIndex::getInstance()->flush();
+}
+
+void MetadataIndexer::index(const QVector<MetadataRequest> &requests, int generation) {
+    for(int i = 0; i < requests.size(); i += INDEX_BATCH_SIZE) {
+        auto runnable = new MetadataIndexerRunnable(requests.mid(i, INDEX_BATCH_SIZE), generation);
+        connect(runnable, &MetadataIndexerRunnable::finished, this, &MetadataIndexer::metadataReady);
+        runnable->setAutoDelete(true);
+        pool.start(runnable, Executor::BACKGROUND);
+    }
+}
+
+void MetadataIndexer::clearTasks() {
+    pool.clear();
+}
+
+FileMetadata MetadataIndexer::extract(const QString &path) {
+    FileMetadata metadata;
+    DocumentInfo info(path);
+    metadata.type = info.type();
+    // players deal with videos; nothing cheap to get from them
+    if(metadata.type == DocumentType::NONE || metadata.type == DocumentType::VIDEO)
+        return metadata;
+    metadata.orientation = info.exifOrientation();
+    auto file = info.fileData();
+    // no copy when mapped, so tiff-based files can be read in full
+    metadata.captureTime = readCaptureTime(file->head(file->isMapped() ? file->size() : EXIF_READ_LIMIT));
+    // header only for all the formats we care about
+    auto device = file->device();
+    QImageReader reader(device.get(), info.format().toStdString().c_str());
+    QSize size = reader.size();
+    if(size.isValid()) {
+        // 90 degree rotations
+        if(metadata.orientation >= 4)
+            size.transpose();
+        metadata.width = size.width();
+        metadata.height = size.height();
+    }
+    return metadata;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QVector>
+#include <QImageReader>
+#include "metadataindex.h"
+#include "components/executor/executor.h"
+#include "utils/mappedfile.h"
+
+struct MetadataRequest {
+    QString path;
+    quint64 size;
+    qint64 modifyTime; // file_time_type ticks
+    // caller's id for this file, passed back with the result
+    quint32 token;
+};
+
+struct MetadataResult {
+    quint32 token;
+    FileMetadata metadata;
+};
+
+class MetadataIndexerRunnable : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    MetadataIndexerRunnable(QVector<MetadataRequest> _requests, int _generation);
+    void run();
+
+private:
+    QVector<MetadataRequest> requests;
+    int generation;
+
+signals:
+    void finished(int generation, QVector<MetadataResult> results);
+};
+
+// Fills the MetadataIndex in background, reading only file headers.
+// Files already in the index are answered from there.
+class MetadataIndexer : public QObject {
+    Q_OBJECT
+public:
+    MetadataIndexer();
+    ~MetadataIndexer();
+    // generation is passed back as is, to tell apart results for an older list
+    void index(const QVector<MetadataRequest> &requests, int generation);
+    void clearTasks();
+
+    static FileMetadata extract(const QString &path);
+
+private:
+    TaskQueue pool;
+
+signals:
+    void metadataReady(int generation, QVector<MetadataResult> results);
+};
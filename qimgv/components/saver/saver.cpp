@@ -0,0 +1,54 @@
+#include "saver.h"
+
+// mostly encoder-bound; a couple at once is plenty for a batch rotate
+#define SAVE_THREADS 2
+
+Saver::Saver(QObject *parent)
+    : QObject(parent),
+      pending(0)
+{
+    pool.setMaxRunning(SAVE_THREADS);
+}
+
+Saver::~Saver() {
+    // runnables drain their destination before they quit
+    pool.waitForDone();
+}
+
+void Saver::save(const QString &sourcePath, const QString &destPath, std::shared_ptr<const QImage> image, int quality) {
+    if(!image)
+        return;
+    enqueue({ SAVE_IMAGE, sourcePath, destPath, image, quality });
+}
+
+void Saver::reencode(const QString &sourcePath, const QString &destPath, int quality) {
+    enqueue({ SAVE_SOURCE_FILE, sourcePath, destPath, nullptr, quality });
+}
+
+void Saver::copy(const QString &sourcePath, const QString &destPath) {
+    enqueue({ SAVE_COPY, sourcePath, destPath, nullptr, 0 });
+}
+
+void Saver::enqueue(const SaveJob &job) {
+    pending++;
+    if(!queue.push(job))
+        return;
+    auto runnable = new SaverRunnable(&queue, job.destPath);
+    connect(runnable, &SaverRunnable::finished, this, &Saver::onJobFinished);
+    runnable->setAutoDelete(true);
+    // below the current image, above anything speculative
+    pool.start(runnable, Executor::PRELOAD);
+}
+
+bool Saver::isBusy() const {
+    return pending > 0;
+}
+
+int Saver::pendingCount() const {
+    return pending;
+}
+
+void Saver::onJobFinished(QString sourcePath, QString destPath, bool success) {
+    pending--;
+    emit saveFinished(sourcePath, destPath, success);
+}
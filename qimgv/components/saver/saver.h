@@ -0,0 +1,38 @@
+#pragma once
+
+#include <QObject>
+#include "saverrunnable.h"
+#include "components/executor/executor.h"
+
+// Encodes and writes images on the worker threads, so the gui never waits
+// for an encoder. Jobs hold an immutable copy of the image; the caller is
+// free to keep editing it.
+// Jobs for the same destination are written one after another, in the order
+// they came in; different files are written in parallel.
+class Saver : public QObject {
+    Q_OBJECT
+public:
+    explicit Saver(QObject *parent = nullptr);
+    // waits for everything queued; nothing is lost on exit
+    ~Saver();
+    void save(const QString &sourcePath, const QString &destPath, std::shared_ptr<const QImage> image, int quality);
+    // decodes sourcePath on the worker first; for unedited images
+    // that were only decoded at reduced size
+    void reencode(const QString &sourcePath, const QString &destPath, int quality);
+    // for files written without re-encoding (animations)
+    void copy(const QString &sourcePath, const QString &destPath);
+    bool isBusy() const;
+    int pendingCount() const;
+
+signals:
+    void saveFinished(QString sourcePath, QString destPath, bool success);
+
+private:
+    void enqueue(const SaveJob &job);
+    SaveQueue queue;
+    TaskQueue pool;
+    int pending;
+
+private slots:
+    void onJobFinished(QString sourcePath, QString destPath, bool success);
+};
@@ -0,0 +1,57 @@
+#include "saverrunnable.h"
+
+bool SaveQueue::push(const SaveJob &job) {
+    QMutexLocker lock(&mutex);
+    bool idle = !jobs.contains(job.destPath);
+    jobs[job.destPath].push_back(job);
+    return idle;
+}
+
+bool SaveQueue::takeNext(const QString &destPath, SaveJob &job) {
+    QMutexLocker lock(&mutex);
+    auto it = jobs.find(destPath);
+    if(it == jobs.end())
+        return false;
+    if(it->empty()) {
+        jobs.erase(it);
+        return false;
+    }
+    job = it->front();
+    it->pop_front();
+    return true;
+}
+
+// ##############################################################
+
+SaverRunnable::SaverRunnable(SaveQueue *_queue, QString _destPath)
+    : queue(_queue),
+      destPath(_destPath)
+{
+}
+
+void SaverRunnable::run() {
+    SaveJob job;
+    while(queue->takeNext(destPath, job)) {
+        bool success = false;
+        switch(job.type) {
+            case SAVE_IMAGE:
+                success = ImageLib::save(job.image, job.destPath, job.quality);
+                break;
+            case SAVE_SOURCE_FILE: {
+                // loads at full resolution when no display size is given
+                ImageStatic source(job.sourcePath);
+                auto image = source.getSourceImage();
+                success = image && !image->isNull() && ImageLib::save(image, job.destPath, job.quality);
+                break;
+            }
+            case SAVE_COPY:
+                success = QFile::copy(job.sourcePath, job.destPath);
+                break;
+        }
+        if(!success)
+            qDebug() << "[Saver] could not save" << job.destPath;
+        // let go of the pixels before the next one
+        job.image.reset();
+        emit finished(job.sourcePath, job.destPath, success);
+    }
+}
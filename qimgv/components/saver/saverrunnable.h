@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QObject>
+#include <QRunnable>
+#include <QHash>
+#include <QMutex>
+#include <QFile>
+#include <QDebug>
+#include <deque>
+#include <memory>
+#include "utils/imagelib.h"
+#include "sourcecontainers/imagestatic.h"
+
+enum SaveJobType {
+    SAVE_IMAGE,       // encode the image held by the job
+    SAVE_SOURCE_FILE, // decode the source file here, then encode
+    SAVE_COPY         // copy the source file as is (animations)
+};
+
+struct SaveJob {
+    SaveJobType type;
+    QString sourcePath;
+    QString destPath;
+    // SAVE_IMAGE only
+    std::shared_ptr<const QImage> image;
+    int quality;
+};
+
+// Jobs waiting to be written, per destination.
+// A destination is listed here for as long as a runnable works on it.
+class SaveQueue {
+public:
+    // true if nobody works on this destination yet; start a runnable then
+    bool push(const SaveJob &job);
+    // false when the destination is done; it's unlisted then
+    bool takeNext(const QString &destPath, SaveJob &job);
+
+private:
+    QMutex mutex;
+    QHash<QString, std::deque<SaveJob>> jobs;
+};
+
+// Writes every job queued for one destination, oldest first.
+class SaverRunnable : public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    SaverRunnable(SaveQueue *_queue, QString _destPath);
+    void run();
+
+private:
+    SaveQueue *queue;
+    QString destPath;
+
+signals:
+    void finished(QString sourcePath, QString destPath, bool success);
+};
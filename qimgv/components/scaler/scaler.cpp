@@ -8,73 +8,51 @@
  *    start the last task that came and ignore the middle ones.
  */
 
-Scaler::Scaler(Cache *_cache, QObject *parent)
+Scaler::Scaler(ScaledCache *_scaledCache, QObject *parent)
     : QObject(parent),
+      pool(1),
+      prescalePool(1),
       buffered(false),
       running(false),
       currentRequestTimestamp(0),
-      cache(_cache)
+      scaledCache(_scaledCache)
 {
     sem = new QSemaphore(1);
-    pool = new QThreadPool(this);
-    pool->setMaxThreadCount(1);
-    runnable = new ScalerRunnable();
+    runnable = new ScalerRunnable(scaledCache);
     runnable->setAutoDelete(false);
     connect(this, &Scaler::startBufferedRequest, this, &Scaler::slotStartBufferedRequest, Qt::DirectConnection);
     connect(runnable, &ScalerRunnable::started, this, &Scaler::onTaskStart, Qt::DirectConnection);
     connect(runnable, &ScalerRunnable::finished, this, &Scaler::onTaskFinish, Qt::DirectConnection);
     connect(this, &Scaler::acceptScalingResult, this, &Scaler::slotForwardScaledResult, Qt::QueuedConnection);
+    // results may depend on settings (smooth upscaling etc)
+    connect(settings, &Settings::settingsChanged, this, [this]() {
+        scaledCache->clear();
+    });
 }
 
 void Scaler::requestScaled(ScalerRequest req) {
     sem->acquire(1);
-    if(!running) {
-//////////////////////////////////
-        if(!buffered) {
-            bufferedRequest = req;
-            buffered = true;
-          //qDebug() << "1 requestScaled() - locking..  " <<  req.image->name();
-            cache->reserve(req.image->fileName());
-          //qDebug() << "1 requestScaled() - LOCKED!  " <<  req.image->name();
-            startRequest(req);
-        } else if(bufferedRequest.image != req.image) {
-          //qDebug() << "2 requestScaled() - locking...  " <<  req.image->name();
-            cache->reserve(req.image->fileName());
-          //qDebug() << "2 requestScaled() - LOCKED!  " <<  req.image->name();
-            auto tmp = bufferedRequest;
-            bufferedRequest = req;
-            buffered = true;
-            if(startedRequest.image != tmp.image) {
-                cache->release(tmp.image->fileName());
-              //qDebug() << "2 requestScaled() - RELEASED!  " <<  tmp.image->name();
-            }
-        } else {
-            bufferedRequest = req;
-            buffered = true;
-        }
-//////////////////////////////
-    } else {
-        if(!buffered) {
-            if(req.image != startedRequest.image)
-                cache->reserve(req.image->fileName());
-            bufferedRequest = req;
-            buffered = true;
-        } else {
-            if(req.image == bufferedRequest.image) {
-                bufferedRequest = req;
-                buffered = true;
-            } else {
-                if(bufferedRequest.image != startedRequest.image) {
-                    //qDebug() << "4 RELEASING " << bufferedRequest.image->name();
-                    cache->release(bufferedRequest.image->fileName());
-                }
-                if(req.image != startedRequest.image)
-                    cache->reserve(req.image->fileName());
-                bufferedRequest = req;
-                buffered = true;
-            }
+    // cached and nothing in flight: answer right away so the viewer
+    // never shows the unscaled preview
+    QImage cached;
+    if(!running && !buffered && scaledCache->get(req, cached)) {
+        sem->release(1);
+        perfCount("scaled cache hit");
+        QPixmap *pixmap;
+        {
+            PerfScope scope("pixmap", req.path);
+            pixmap = new QPixmap(QPixmap::fromImage(cached));
         }
+        emit scalingFinished(pixmap, req);
+        return;
     }
+    // The request holds its own reference to the image, so it stays valid
+    // even if the cache drops it in the meantime.
+    bool idle = !running && !buffered;
+    bufferedRequest = req;
+    buffered = true;
+    if(idle)
+        startRequest(req);
     sem->release(1);
 }
 
@@ -85,21 +63,12 @@ void Scaler::onTaskStart(ScalerRequest req) {
     if(buffered && bufferedRequest == req) {
         buffered = false;
     }
-    startedRequest = req;
-  //qDebug() << "onTaskStart(): " << req.image->name();
     sem->release(1);
 }
 
 void Scaler::onTaskFinish(QImage *scaled, ScalerRequest req) {
     sem->acquire(1);
     running = false;
-    if(buffered && bufferedRequest.image == req.image) {
-    } else {
-      //qDebug() << "onTaskFinish() - 2 releasing..  " <<  req.image->name();
-        QString name = req.image->fileName();
-        cache->release(req.image->fileName());
-      //qDebug() << "onTaskFinish() - 2 RELEASED!  " <<  name;
-    }
     if(buffered) {
       //qDebug() << "onTaskFinish - startingBuffered: " << bufferedRequest.string;
         delete scaled;
@@ -107,6 +76,8 @@ void Scaler::onTaskFinish(QImage *scaled, ScalerRequest req) {
         emit startBufferedRequest();
         sem->release(1);
     } else {
+        // don't keep the image alive for nothing
+        bufferedRequest = ScalerRequest();
         sem->release(1);
         emit acceptScalingResult(scaled, req);
     }
@@ -118,12 +89,25 @@ void Scaler::slotStartBufferedRequest() {
 
 void Scaler::slotForwardScaledResult(QImage *image, ScalerRequest req) {
     QPixmap *pixmap = new QPixmap();
-    *pixmap = QPixmap::fromImage(*image);
+    {
+        PerfScope scope("pixmap", req.path);
+        *pixmap = QPixmap::fromImage(*image);
+    }
     delete image;
     emit scalingFinished(pixmap, req);
 }
 
+// Low priority background job; the result only goes into the cache.
+void Scaler::prescale(ScalerRequest req) {
+    if(!req.image || scaledCache->contains(req))
+        return;
+    auto task = new ScalerRunnable(scaledCache, true);
+    task->setRequest(req);
+    task->setAutoDelete(true);
+    prescalePool.start(task, Executor::PRELOAD);
+}
+
 void Scaler::startRequest(ScalerRequest req) {
     runnable->setRequest(req);
-    pool->start(runnable);
+    pool.start(runnable, Executor::SCALING);
 }
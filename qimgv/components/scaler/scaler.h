@@ -1,17 +1,17 @@
 #pragma once
 
 #include <QObject>
-#include <QThreadPool>
 #include <QThread>
 #include <QMutex>
-#include "components/cache/cache.h"
+#include "components/cache/scaledcache.h"
 #include "scalerrequest.h"
 #include "scalerrunnable.h"
+#include "components/executor/executor.h"
 
 class Scaler : public QObject {
     Q_OBJECT
 public:
-    explicit Scaler(Cache *_cache, QObject *parent = nullptr);
+    explicit Scaler(ScaledCache *_scaledCache, QObject *parent = nullptr);
 
 signals:
     void scalingFinished(QPixmap* result, ScalerRequest request);
@@ -20,6 +20,7 @@ signals:
 
 public slots:
     void requestScaled(ScalerRequest req);
+    void prescale(ScalerRequest req);
 
 private slots:
     void onTaskStart(ScalerRequest req);
@@ -28,13 +29,14 @@ private slots:
     void slotForwardScaledResult(QImage *image, ScalerRequest req);
 
 private:
-    QThreadPool *pool;
+    // runnable is reused, so one at a time
+    TaskQueue pool, prescalePool;
     ScalerRunnable *runnable;
     bool buffered, running;
     clock_t currentRequestTimestamp;
-    ScalerRequest bufferedRequest, startedRequest;
+    ScalerRequest bufferedRequest;
 
-    Cache *cache;
+    ScaledCache *scaledCache;
 
     void startRequest(ScalerRequest req);
 
@@ -1,24 +1,45 @@
 #include "scalerrunnable.h"
 
-#include <QElapsedTimer>
-
-ScalerRunnable::ScalerRunnable() {
+ScalerRunnable::ScalerRunnable(ScaledCache *_scaledCache, bool _cacheOnly)
+    : scaledCache(_scaledCache),
+      cacheOnly(_cacheOnly)
+{
 }
 
 void ScalerRunnable::setRequest(ScalerRequest r) {
     req = r;
 }
 
+QImage *ScalerRunnable::scale(const ScalerRequest &r) const {
+    PerfScope scope("scale", r.path);
+    if(r.filter == 0 || (r.size.width() > r.image->width() && !settings->smoothUpscaling()))
+        return ImageLib::scaled(r.image->getDisplayImage(), r.size, QI_FILTER_NEAREST);
+    return ImageLib::scaled(r.image->getDisplayImage(), r.size, r.filter);
+}
+
 void ScalerRunnable::run() {
-    emit started(req);
-    //QElapsedTimer t;
-    //t.start();
+    // take it out, so the image isn't held after we're done
+    ScalerRequest r;
+    std::swap(r, req);
+    if(cacheOnly) {
+        if(!scaledCache || scaledCache->contains(r))
+            return;
+        std::unique_ptr<QImage> scaled(scale(r));
+        if(scaled)
+            scaledCache->insert(r, *scaled);
+        return;
+    }
+    emit started(r);
     QImage *scaled = nullptr;
-    if(req.filter == 0 || (req.size.width() > req.image->width() && !settings->smoothUpscaling())) {
-        scaled = ImageLib::scaled(req.image->getImage(), req.size, QI_FILTER_NEAREST);
+    QImage cached;
+    if(scaledCache && scaledCache->get(r, cached)) {
+        perfCount("scaled cache hit");
+        scaled = new QImage(cached);
     } else {
-        scaled = ImageLib::scaled(req.image->getImage(), req.size, req.filter);
+        perfCount("scaled cache miss");
+        scaled = scale(r);
+        if(scaledCache && scaled)
+            scaledCache->insert(r, *scaled);
     }
-    //qDebug() << ">> " << req.size << ": " << t.elapsed();
-    emit finished(scaled, req);
+    emit finished(scaled, r);
 }
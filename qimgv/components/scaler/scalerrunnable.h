@@ -4,16 +4,18 @@
 #include <QRunnable>
 #include <QThread>
 #include <QDebug>
-#include "components/cache/cache.h"
+#include "components/cache/scaledcache.h"
 #include "scalerrequest.h"
 #include "utils/imagelib.h"
+#include "utils/perftrace.h"
 #include "settings.h"
 
 class ScalerRunnable : public QObject, public QRunnable
 {
     Q_OBJECT
 public:
-    explicit ScalerRunnable();
+    // cacheOnly: the result goes into the cache and nowhere else; nothing is emitted
+    explicit ScalerRunnable(ScaledCache *_scaledCache, bool _cacheOnly = false);
     void setRequest(ScalerRequest r);
     void run();
 signals:
@@ -21,6 +23,9 @@ signals:
     void finished(QImage*, ScalerRequest);
 
 private:
+    QImage *scale(const ScalerRequest &r) const;
     ScalerRequest req;
+    ScaledCache *scaledCache;
+    bool cacheOnly;
     const float CMPL_FALLBACK_THRESHOLD = 70.0; // equivalent of ~ 5000x3500 @ 32bpp
 };
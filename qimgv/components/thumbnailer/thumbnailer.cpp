@@ -1,43 +1,47 @@
 #include "thumbnailer.h"
 
-Thumbnailer::Thumbnailer() {
-    cache = new ThumbnailCache();
-    pool = new QThreadPool(this);
-    int threads = settings->thumbnailerThreadCount();
-    int globalThreads = QThreadPool::globalInstance()->maxThreadCount();
-    if(threads > globalThreads)
-        threads = globalThreads;
-    pool->setMaxThreadCount(threads);
+Thumbnailer::Thumbnailer(bool _useCaches)
+    : cache(nullptr),
+      sharedCache(nullptr),
+      useCaches(_useCaches)
+{
+    if(useCaches) {
+        cache = new ThumbnailCache();
+        sharedCache = new SharedThumbnailCache();
+    }
+    // the executor decides how many actually run at once
+    pool.setMaxRunning(settings->thumbnailerThreadCount());
 }
 
 Thumbnailer::~Thumbnailer() {
-    pool->clear();
-    pool->waitForDone();
+    pool.clear();
+    pool.waitForDone();
 }
 
 void Thumbnailer::waitForDone() {
-    pool->waitForDone();
+    pool.waitForDone();
 }
 
 void Thumbnailer::clearTasks() {
-    pool->clear();
+    pool.clear();
 }
 
 std::shared_ptr<Thumbnail> Thumbnailer::getThumbnail(QString filePath, int size) {
     return ThumbnailerRunnable::generate(nullptr, filePath, size, false, false);
 }
 
-void Thumbnailer::getThumbnailAsync(QString path, int size, bool crop, bool force) {
+void Thumbnailer::getThumbnailAsync(QString path, int size, bool crop, bool force, bool visible) {
     if(!runningTasks.contains(path, size))
-        startThumbnailerThread(path, size, crop, force);
+        startThumbnailerThread(path, size, crop, force, visible);
 }
 
-void Thumbnailer::startThumbnailerThread(QString filePath, int size, bool crop, bool force) {
-    auto runnable = new ThumbnailerRunnable(settings->useThumbnailCache() ? cache : nullptr, filePath, size, crop, force);
+void Thumbnailer::startThumbnailerThread(QString filePath, int size, bool crop, bool force, bool visible) {
+    auto runnable = new ThumbnailerRunnable((useCaches && settings->useThumbnailCache()) ? cache : nullptr, filePath, size, crop, force,
+                                            (useCaches && settings->sharedThumbnailCache()) ? sharedCache : nullptr);
     connect(runnable, &ThumbnailerRunnable::taskStart, this, &Thumbnailer::onTaskStart);
     connect(runnable, &ThumbnailerRunnable::taskEnd, this, &Thumbnailer::onTaskEnd);
     runnable->setAutoDelete(true);
-    pool->start(runnable);
+    pool.start(runnable, visible ? Executor::THUMBNAIL_VISIBLE : Executor::THUMBNAIL_OFFSCREEN);
 }
 
 void Thumbnailer::onTaskStart(QString filePath, int size) {
@@ -1,7 +1,7 @@
 #pragma once
 
-#include <QThreadPool>
 #include "components/thumbnailer/thumbnailerrunnable.h"
+#include "components/executor/executor.h"
 #include "components/cache/thumbnailcache.h"
 #include "settings.h"
 
@@ -9,19 +9,23 @@ class Thumbnailer : public QObject
 {
     Q_OBJECT
 public:
-    explicit Thumbnailer();
+    // useCaches: read & write the thumbnail caches (if enabled in settings)
+    explicit Thumbnailer(bool _useCaches = true);
     ~Thumbnailer();
     static std::shared_ptr<Thumbnail> getThumbnail(QString filePath, int size);
     void clearTasks();
     void waitForDone();
 
 public slots:
-    void getThumbnailAsync(QString path, int size, bool crop, bool force);
+    // visible: on screen right now, as opposed to preloading around it
+    void getThumbnailAsync(QString path, int size, bool crop, bool force, bool visible = true);
 
 private:
     ThumbnailCache *cache;
-    QThreadPool *pool;
-    void startThumbnailerThread(QString filePath, int size, bool crop, bool force);
+    SharedThumbnailCache *sharedCache;
+    bool useCaches;
+    TaskQueue pool;
+    void startThumbnailerThread(QString filePath, int size, bool crop, bool force, bool visible);
     QMultiMap<QString, int> runningTasks;
 
 private slots:
@@ -1,17 +1,21 @@
 #include "thumbnailerrunnable.h"
 
-ThumbnailerRunnable::ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force) :
+// size of one band when decoding in parts; band height is this / image width
+#define DOWNSCALE_BAND_PIXELS (4 * 1024 * 1024) // pixels
+
+ThumbnailerRunnable::ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force, SharedThumbnailCache *_sharedCache) :
     path(_path),
     size(_size),
     crop(_crop),
     force(_force),
-    cache(_cache)
+    cache(_cache),
+    sharedCache(_sharedCache)
 {
 }
 
 void ThumbnailerRunnable::run() {
     emit taskStart(path, size);
-    std::shared_ptr<Thumbnail> thumbnail = generate(cache, path, size, crop, force);
+    std::shared_ptr<Thumbnail> thumbnail = generate(cache, path, size, crop, force, sharedCache);
     emit taskEnd(thumbnail, path);
 }
 
@@ -23,7 +27,8 @@ QString ThumbnailerRunnable::generateIdString(QString path, int size, bool crop)
     return queryStr;
 }
 
-std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache, QString path, int size, bool crop, bool force) {
+std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache, QString path, int size, bool crop, bool force, SharedThumbnailCache *sharedCache) {
+    PerfScope scope("thumbnail", path);
     DocumentInfo imgInfo(path);
     QString thumbnailId = generateIdString(path, size, crop);
     std::unique_ptr<QImage> image;
@@ -36,16 +41,24 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
             image.reset(nullptr);
     }
 
+    if(cache && !force)
+        perfCount(image ? "thumbnail cache hit" : "thumbnail cache miss");
+
+    if(!image && imgInfo.type() == DocumentType::NONE) {
+        std::shared_ptr<Thumbnail> thumbnail(new Thumbnail(imgInfo.fileName(), "", size, nullptr));
+        return thumbnail;
+    }
+
+    bool generated = !image;
+    if(!image && sharedCache && sharedCache->accepts(path))
+        image = fromSharedCache(sharedCache, imgInfo, size, crop, force);
+
     if(!image) {
-        if(imgInfo.type() == DocumentType::NONE) {
-            std::shared_ptr<Thumbnail> thumbnail(new Thumbnail(imgInfo.fileName(), "", size, nullptr));
-            return thumbnail;
-        }
         std::pair<QImage*, QSize> pair;
         if(imgInfo.type() == VIDEO)
             pair = createVideoThumbnail(path, size, crop);
         else
-            pair = createThumbnail(imgInfo.filePath(), imgInfo.format().toStdString().c_str(), size, crop);
+            pair = createThumbnail(*imgInfo.fileData(), imgInfo.format().toStdString().c_str(), size, crop);
         image.reset(pair.first);
         QSize originalSize = pair.second;
 
@@ -54,6 +67,9 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
         // put in image info
         image->setText("originalWidth", QString::number(originalSize.width()));
         image->setText("originalHeight", QString::number(originalSize.height()));
+    }
+
+    if(generated) {
         image->setText("lastModified", time);
 
         if(imgInfo.type() == ANIMATED)
@@ -64,7 +80,7 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
         if(cache) {
             // save thumbnail if it makes sense
             // FIXME: avoid too much i/o
-            if(originalSize.width() > size || originalSize.height() > size)
+            if(image->text("originalWidth").toInt() > size || image->text("originalHeight").toInt() > size)
                 cache->saveThumbnail(image.get(), thumbnailId);
         }
     }
@@ -84,14 +100,86 @@ std::shared_ptr<Thumbnail> ThumbnailerRunnable::generate(ThumbnailCache* cache,
     }
     std::shared_ptr<QPixmap> pixmapPtr(tmpPixmap);
     std::shared_ptr<Thumbnail> thumbnail(new Thumbnail(imgInfo.fileName(), label, size, pixmapPtr));
+    // stored as read from the file, while the pixmap is already rotated
+    QSize originalSize(image->text("originalWidth").toInt(), image->text("originalHeight").toInt());
+    if(imgInfo.exifOrientation() >= 4)
+        originalSize.transpose();
+    thumbnail->setOriginalSize(originalSize);
     return thumbnail;
 }
 
 ThumbnailerRunnable::~ThumbnailerRunnable() {
 }
 
-std::pair<QImage*, QSize> ThumbnailerRunnable::createThumbnail(QString path, const char *format, int size, bool squared) {
-    QImageReader *reader = new QImageReader(path, format);
+// Takes the thumbnail from the shared cache, or makes one there first.
+// Shared ones are bigger (bucket size) and uncropped; ours is cut from it.
+std::unique_ptr<QImage> ThumbnailerRunnable::fromSharedCache(SharedThumbnailCache *sharedCache, DocumentInfo &imgInfo, int size, bool crop, bool force) {
+    int bucket = SharedThumbnailCache::bucketSize(size);
+    if(!bucket)
+        return nullptr;
+    qint64 mtime = imgInfo.lastModified().toSecsSinceEpoch();
+    std::unique_ptr<QImage> shared;
+    QSize originalSize;
+    if(!force) {
+        shared.reset(sharedCache->read(imgInfo.filePath(), mtime, bucket));
+        perfCount(shared ? "shared thumbnail hit" : "shared thumbnail miss");
+    }
+    if(shared) {
+        // optional in the standard
+        originalSize = QSize(shared->text("Thumb::Image::Width").toInt(), shared->text("Thumb::Image::Height").toInt());
+        if(originalSize.isEmpty() && imgInfo.type() != VIDEO) {
+            auto file = imgInfo.fileData();
+            auto device = file->device();
+            originalSize = QImageReader(device.get(), imgInfo.format().toStdString().c_str()).size();
+        }
+        if(originalSize.isEmpty())
+            return nullptr;
+    } else {
+        std::pair<QImage*, QSize> pair;
+        if(imgInfo.type() == VIDEO)
+            pair = createVideoThumbnail(imgInfo.filePath(), bucket, false);
+        else
+            pair = createThumbnail(*imgInfo.fileData(), imgInfo.format().toStdString().c_str(), bucket, false);
+        shared.reset(pair.first);
+        originalSize = pair.second;
+        if(!shared || shared->isNull())
+            return nullptr;
+        shared = ImageLib::exifRotated(std::move(shared), imgInfo.exifOrientation());
+        // small images are as quick to read as their thumbnails
+        if(originalSize.width() > bucket || originalSize.height() > bucket)
+            sharedCache->write(*shared, imgInfo.filePath(), mtime, imgInfo.fileSize(), originalSize);
+    }
+    Qt::AspectRatioMode ARMode = crop ? Qt::KeepAspectRatioByExpanding : Qt::KeepAspectRatio;
+    QSize scaledSize = shared->size().scaled(size, size, ARMode);
+    std::unique_ptr<QImage> result;
+    if(scaledSize.width() >= shared->width() && !crop) {
+        result = std::move(shared);
+    } else {
+        QImage scaled = shared->scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+        if(crop) {
+            QRect clip(0, 0, size, size);
+            clip.moveCenter(QRect(QPoint(0, 0), scaledSize).center());
+            result.reset(ImageLib::croppedRaw(&scaled, clip));
+        } else {
+            result.reset(new QImage(scaled));
+        }
+    }
+    result->setText("originalWidth", QString::number(originalSize.width()));
+    result->setText("originalHeight", QString::number(originalSize.height()));
+    return result;
+}
+
+std::pair<QImage*, QSize> ThumbnailerRunnable::createThumbnail(const MappedFile &file, const char *format, int size, bool squared) {
+#ifdef USE_EXIV2
+    if(hasExifPreviews(format)) {
+        auto preview = createThumbnailFromPreview(file, format, size, squared);
+        if(preview.first)
+            return preview;
+    }
+#endif
+    file.willNeed();
+    auto device = file.device();
+    QImageReader *reader = new QImageReader(device.get(), format);
     Qt::AspectRatioMode ARMode = squared?
                 (Qt::KeepAspectRatioByExpanding):(Qt::KeepAspectRatio);
     QImage *result = nullptr;
@@ -118,41 +206,158 @@ std::pair<QImage*, QSize> ThumbnailerRunnable::createThumbnail(QString path, con
             result = nullptr;
             // Force reset reader because it is really finicky
             // and can fail on the second read attempt (yeah wtf)
-            reader->setFileName("");
             delete reader;
-            reader = new QImageReader(path, format);
+            device = file.device();
+            reader = new QImageReader(device.get(), format);
         }
     }
     if(manualResize) { // manual resize & crop. slower but should just work
-        QImage *fullSize = new QImage();
-        reader->read(fullSize);
-        if(indexed) {
-            auto newFmt = QImage::Format_RGB32;
-            if(fullSize->hasAlphaChannel())
-                newFmt = QImage::Format_ARGB32;
-            auto tmp = new QImage(fullSize->convertToFormat(newFmt));
+        originalSize = reader->size();
+        QSize scaledSize = originalSize.scaled(size, size, ARMode);
+        QImage scaled;
+        if(AreaDownscaler::canDownscale(originalSize, scaledSize))
+            scaled = downscaledRead(file, format, *reader, originalSize, scaledSize);
+        if(scaled.isNull()) {
+            // unknown size, upscaling, or a decoder error; the reader may be used up
+            delete reader;
+            device = file.device();
+            reader = new QImageReader(device.get(), format);
+            QImage *fullSize = new QImage();
+            reader->read(fullSize);
+            if(indexed) {
+                auto newFmt = QImage::Format_RGB32;
+                if(fullSize->hasAlphaChannel())
+                    newFmt = QImage::Format_ARGB32;
+                auto tmp = new QImage(fullSize->convertToFormat(newFmt));
+                delete fullSize;
+                fullSize = tmp;
+            }
+            originalSize = fullSize->size();
+            scaledSize = fullSize->size().scaled(size, size, ARMode);
+            scaled = fullSize->scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
             delete fullSize;
-            fullSize = tmp;
         }
-        originalSize = fullSize->size();
-        QSize scaledSize = fullSize->size().scaled(size, size, ARMode);
         if(squared) {
             QRect clip(0, 0, size, size);
             QRect scaledRect(QPoint(0,0), scaledSize);
             clip.moveCenter(scaledRect.center());
-            QImage scaled = QImage(fullSize->scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
             result = ImageLib::croppedRaw(&scaled, clip);
         } else {
-            result = new QImage(fullSize->scaled(scaledSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation));
+            result = new QImage(scaled);
         }
-        delete fullSize;
     }
-    // force reader to close file so it can be deleted later
-    reader->setFileName("");
     delete reader;
     return std::make_pair(result, originalSize);
 }
 
+// Decodes and area-averages at once, without scaling temporaries.
+// Decoders that can read a part of the image (clip rect) are read in bands
+// of rows, which keeps only one band in memory. None of the built-in
+// handlers that end up here can do that (png, tiff, gif, ...), so for them
+// this is still one full decode, just without the extra copies on top.
+// Returns a null image on failure.
+QImage ThumbnailerRunnable::downscaledRead(const MappedFile &file, const char *format, QImageReader &reader, QSize sourceSize, QSize scaledSize) {
+    AreaDownscaler downscaler(sourceSize, scaledSize);
+    // Without native clip rect support QImageReader decodes the whole image
+    // for every band, so that would be quadratic; read once instead.
+    // Same for anything that fits into a single band anyway.
+    qint64 pixels = static_cast<qint64>(sourceSize.width()) * sourceSize.height();
+    bool banded = pixels > DOWNSCALE_BAND_PIXELS && reader.supportsOption(QImageIOHandler::ClipRect);
+    if(banded) {
+        int bandHeight = qMax(1, DOWNSCALE_BAND_PIXELS / sourceSize.width());
+        for(int y = 0; y < sourceSize.height(); y += bandHeight) {
+            // one decode per band; a reader won't go twice over the same device
+            auto device = file.device();
+            QImageReader bandReader(device.get(), format);
+            bandReader.setClipRect(QRect(0, y, sourceSize.width(), qMin(bandHeight, sourceSize.height() - y)));
+            QImage band;
+            if(!bandReader.read(&band))
+                return QImage();
+            downscaler.addRows(band, y);
+        }
+    } else {
+        QImage fullSize;
+        if(!reader.read(&fullSize) || fullSize.size() != sourceSize)
+            return QImage();
+        downscaler.addRows(fullSize, 0, fullSize.height());
+    }
+    if(!downscaler.isComplete())
+        return QImage();
+    return downscaler.result();
+}
+
+#ifdef USE_EXIV2
+// Formats that can carry exif previews; everything else goes
+// straight to the decoder without touching exiv2.
+bool ThumbnailerRunnable::hasExifPreviews(const char *format) {
+    static const QSet<QByteArray> formats = {
+        "jpg", "jpeg", "tif", "tiff", "dng", "cr2", "crw", "nef", "nrw", "arw",
+        "sr2", "srf", "orf", "rw2", "raf", "pef", "srw", "kdc", "mrw", "erf",
+        "3fr", "rwl", "iiq", "x3f", "raw"
+    };
+    return formats.contains(QByteArray(format).toLower());
+}
+
+// Camera jpegs and raw files usually carry smaller copies of themselves
+// in exif. Takes the smallest one that still covers the thumbnail,
+// which saves decoding the main image. Previews are stored in the same
+// orientation as the main image, so the caller rotates as usual.
+// Returns nullptr when there is nothing suitable.
+std::pair<QImage*, QSize> ThumbnailerRunnable::createThumbnailFromPreview(const MappedFile &file, const char *format, int size, bool squared) {
+    std::pair<QImage*, QSize> none(nullptr, QSize());
+    // header only
+    auto device = file.device();
+    QSize originalSize = QImageReader(device.get(), format).size();
+    if(originalSize.isEmpty())
+        return none;
+    Qt::AspectRatioMode ARMode = squared ? Qt::KeepAspectRatioByExpanding : Qt::KeepAspectRatio;
+    QSize scaledSize = originalSize.scaled(size, size, ARMode);
+    try {
+        std::unique_ptr<Exiv2::Image> image;
+        if(file.isMapped())
+            image = Exiv2::ImageFactory::open(file.data(), file.size());
+        else
+            image = Exiv2::ImageFactory::open(toStdString(file.path()));
+        if(!image)
+            return none;
+        image->readMetadata();
+        Exiv2::PreviewManager manager(*image);
+        // smallest first
+        for(auto &properties : manager.getPreviewProperties()) {
+            qint64 width = properties.width_, height = properties.height_;
+            if(width < scaledSize.width() || height < scaledSize.height())
+                continue;
+            // some cameras letterbox the small ones
+            if(qAbs(width * originalSize.height() - height * originalSize.width()) > width * originalSize.height() / 50)
+                continue;
+            Exiv2::PreviewImage preview = manager.getPreviewImage(properties);
+            QByteArray data = QByteArray::fromRawData(reinterpret_cast<const char*>(preview.pData()), static_cast<int>(preview.size()));
+            QBuffer buffer(&data);
+            buffer.open(QIODevice::ReadOnly);
+            QImageReader reader(&buffer);
+            // orientation is the main image's business
+            reader.setAutoTransform(false);
+            QSize previewScaledSize = QSize(static_cast<int>(width), static_cast<int>(height)).scaled(size, size, ARMode);
+            reader.setScaledSize(previewScaledSize);
+            if(squared) {
+                QRect clip(0, 0, size, size);
+                clip.moveCenter(QRect(QPoint(0, 0), previewScaledSize).center());
+                reader.setScaledClipRect(clip);
+            }
+            QImage *result = new QImage();
+            if(reader.read(result) && !result->isNull()) {
+                perfCount("thumbnail from exif preview");
+                return std::make_pair(result, originalSize);
+            }
+            delete result;
+        }
+    } catch (Exiv2::Error &) {
+        // unreadable or no previews; the caller decodes the image instead
+    }
+    return none;
+}
+#endif
+
 std::pair<QImage*, QSize> ThumbnailerRunnable::createVideoThumbnail(QString path, int size, bool squared) {
     QFileInfo fi(path);
     QImageReader reader;
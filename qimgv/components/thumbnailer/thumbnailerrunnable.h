@@ -4,11 +4,15 @@
 #include <QProcess>
 #include <QThread>
 #include <QCryptographicHash>
+#include <QSet>
 #include <ctime>
 #include "sourcecontainers/thumbnail.h"
 #include "components/cache/thumbnailcache.h"
+#include "components/cache/sharedthumbnailcache.h"
 #include "utils/imagefactory.h"
 #include "utils/imagelib.h"
+#include "utils/areadownscaler.h"
+#include "utils/perftrace.h"
 #include "settings.h"
 #include <memory>
 #include <QImageWriter>
@@ -16,18 +20,25 @@
 class ThumbnailerRunnable : public QObject, public QRunnable {
     Q_OBJECT
 public:
-    ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force);
+    ThumbnailerRunnable(ThumbnailCache* _cache, QString _path, int _size, bool _crop, bool _force, SharedThumbnailCache *_sharedCache = nullptr);
     ~ThumbnailerRunnable();
     void run();
-    static std::shared_ptr<Thumbnail> generate(ThumbnailCache *cache, QString path, int size, bool crop, bool force);
+    static std::shared_ptr<Thumbnail> generate(ThumbnailCache *cache, QString path, int size, bool crop, bool force, SharedThumbnailCache *sharedCache = nullptr);
 private:
     static QString generateIdString(QString path, int size, bool crop);
-    static std::pair<QImage*, QSize> createThumbnail(QString path, const char* format, int size, bool crop);
+    static std::pair<QImage*, QSize> createThumbnail(const MappedFile &file, const char* format, int size, bool crop);
     static std::pair<QImage*, QSize> createVideoThumbnail(QString path, int size, bool crop);
+    static QImage downscaledRead(const MappedFile &file, const char* format, QImageReader &reader, QSize sourceSize, QSize scaledSize);
+#ifdef USE_EXIV2
+    static bool hasExifPreviews(const char* format);
+    static std::pair<QImage*, QSize> createThumbnailFromPreview(const MappedFile &file, const char* format, int size, bool crop);
+#endif
+    static std::unique_ptr<QImage> fromSharedCache(SharedThumbnailCache *sharedCache, DocumentInfo &imgInfo, int size, bool crop, bool force);
     QString path;
     int size;
     bool crop, force;
     ThumbnailCache* cache = nullptr;
+    SharedThumbnailCache *sharedCache = nullptr;
 
 signals:
     void taskStart(QString, int);
@@ -11,13 +11,23 @@
 #include <tchar.h>
 #endif
 
+// steps closer together than this are treated as key auto-repeat
+#define NAVIGATION_REPEAT_INTERVAL  120 // ms
+// full load starts after this much time without a step
+#define NAVIGATION_SETTLE_TIMEOUT   150 // ms
+#define NAVIGATION_PREVIEW_SIZE     512 // px
+// "Saving..." stays up until the result replaces it
+#define SAVE_MESSAGE_DURATION       30000 // ms
+
 Core::Core()
     : QObject(),
       folderEndAction(FOLDER_END_NO_ACTION),
       loopSlideshow(false),
       mDrag(nullptr),
       slideshow(false),
-      shuffle(false)
+      shuffle(false),
+      // navigation previews are throwaway; don't fill the caches with them
+      previewer(false)
 {
     loadTranslation();
     initGui();
@@ -26,6 +36,10 @@ Core::Core()
     initActions();
     readSettings();
     slideshowTimer.setSingleShot(true);
+    navigationSettleTimer.setSingleShot(true);
+    navigationSettleTimer.setInterval(NAVIGATION_SETTLE_TIMEOUT);
+    connect(&navigationSettleTimer, &QTimer::timeout, this, &Core::onNavigationSettled);
+    connect(&previewer, &Thumbnailer::thumbnailReady, this, &Core::onPreviewReady);
     connect(settings, &Settings::settingsChanged, this, &Core::readSettings);
 
     QVersionNumber lastVersion = settings->lastVersion();
@@ -42,8 +56,6 @@ void Core::readSettings() {
     bool showDirs = (settings->folderViewMode() == FV_EXT_FOLDERS);
     if(folderViewPresenter.showDirs() != showDirs)
         folderViewPresenter.setShowDirs(showDirs);
-    if(shuffle)
-        syncRandomizer();
 }
 
 void Core::showGui() {
@@ -102,6 +114,7 @@ void Core::connectComponents() {
     connect(mw, &MW::moveRequested,         this, &Core::moveCurrentFile);
     connect(mw, &MW::copyUrlsRequested,     this, qOverload<QList<QString>, QString>(&Core::copyPathsTo));
     connect(mw, &MW::moveUrlsRequested,     this, &Core::movePathsTo);
+    connect(mw, &MW::cancelFileOperationsRequested, this, &Core::cancelFileOperations);
     connect(mw, &MW::cropRequested,         this, &Core::crop);
     connect(mw, &MW::cropAndSaveRequested,  this, &Core::cropAndSave);
     connect(mw, &MW::saveAsClicked,         this, &Core::requestSavePath);
@@ -117,6 +130,7 @@ void Core::connectComponents() {
     connect(mw, &MW::playbackFinished, this, &Core::onPlaybackFinished);
 
     connect(mw, &MW::scalingRequested, this, &Core::scalingRequest);
+    connect(mw, &MW::fullResolutionRequested, this, &Core::onFullResolutionRequested);
     connect(model->scaler, &Scaler::scalingFinished, this, &Core::onScalingFinished);
 
     connect(model.get(), &DirectoryModel::fileAdded,      this, &Core::onFileAdded);
@@ -127,7 +141,13 @@ void Core::connectComponents() {
     connect(model.get(), &DirectoryModel::imageReady,     this, &Core::onModelItemReady);
     connect(model.get(), &DirectoryModel::imageUpdated,   this, &Core::onModelItemUpdated);
     connect(model.get(), &DirectoryModel::sortingChanged, this, &Core::onModelSortingChanged);
+    connect(model.get(), &DirectoryModel::listChanged, this, &Core::onModelListChanged);
     connect(model.get(), &DirectoryModel::loadFailed,     this, &Core::onLoadFailed);
+    connect(model.get(), &DirectoryModel::exifTagsReady,  this, &Core::onModelExifTagsReady);
+    connect(model.get(), &DirectoryModel::fullResolutionReady, this, &Core::onModelFullResolutionReady);
+    connect(model.get(), &DirectoryModel::fileOperationsProgress, this, &Core::onFileOperationsProgress);
+    connect(model.get(), &DirectoryModel::fileOperationsFinished, this, &Core::onFileOperationsFinished);
+    connect(model.get(), &DirectoryModel::saveFinished, this, &Core::onModelSaveFinished);
 
     connect(&slideshowTimer, &QTimer::timeout, this, &Core::nextImageSlideshow);
 }
@@ -162,7 +182,7 @@ void Core::initActions() {
     connect(actionManager, &ActionManager::save, this, &Core::saveCurrentFile);
     connect(actionManager, &ActionManager::saveAs, this, &Core::requestSavePath);
     connect(actionManager, &ActionManager::exit, this, &Core::close);
-    connect(actionManager, &ActionManager::closeFullScreenOrExit, mw, &MW::closeFullScreenOrExit);
+    connect(actionManager, &ActionManager::closeFullScreenOrExit, this, &Core::closeFullScreenOrExit);
     connect(actionManager, &ActionManager::removeFile, this, &Core::removePermanent);
     connect(actionManager, &ActionManager::moveToTrash, this, &Core::moveToTrash);
     connect(actionManager, &ActionManager::copyFile, mw, &MW::triggerCopyOverlay);
@@ -202,6 +222,8 @@ void Core::initActions() {
     connect(actionManager, &ActionManager::print, this, &Core::print);
     connect(actionManager, &ActionManager::toggleFullscreenInfoBar, this, &Core::toggleFullscreenInfoBar);
     connect(actionManager, &ActionManager::pasteFile, this, &Core::openFromClipboard);
+    connect(actionManager, &ActionManager::cancelFileOperations, this, &Core::cancelFileOperations);
+    connect(actionManager, &ActionManager::togglePerfOverlay, mw, &MW::togglePerfOverlay);
 }
 
 void Core::loadTranslation() {
@@ -312,9 +334,8 @@ void Core::onPlaybackFinished() {
 
 void Core::syncRandomizer() {
     if(model) {
-        randomizer.setCount(model->fileCount());
-        randomizer.shuffle();
-        randomizer.setCurrent(model->indexOfFile(state.currentFilePath));
+        randomizer.reset(model->fileList());
+        randomizer.setCurrent(state.currentFilePath);
     }
 }
 
@@ -452,15 +473,18 @@ void Core::copyFileClipboard() {
     if(model->isEmpty())
         return;
 
-    QMimeData* mimeData = getMimeDataForImage(model->getImage(selectedPath()), TARGET_CLIPBOARD);
+    auto img = model->getImage(selectedPath());
+    withFullResolution(img, [this, img]() {
+        QMimeData* mimeData = getMimeDataForImage(img, TARGET_CLIPBOARD);
 
-    // mimeData->text() should already contain an url
-    QByteArray gnomeFormat = QByteArray("copy\n").append(QUrl(mimeData->text()).toEncoded());
-    mimeData->setData("x-special/gnome-copied-files", gnomeFormat);
-    mimeData->setData("application/x-kde-cutselection", "0");
+        // mimeData->text() should already contain an url
+        QByteArray gnomeFormat = QByteArray("copy\n").append(QUrl(mimeData->text()).toEncoded());
+        mimeData->setData("x-special/gnome-copied-files", gnomeFormat);
+        mimeData->setData("application/x-kde-cutselection", "0");
 
-    QApplication::clipboard()->setMimeData(mimeData);
-    mw->showMessage(tr("File copied"));
+        QApplication::clipboard()->setMimeData(mimeData);
+        mw->showMessage(tr("File copied"));
+    });
 }
 
 void Core::copyPathClipboard() {
@@ -509,49 +533,8 @@ void Core::openFromClipboard() {
         destPath = mw->getSaveFileName(destPath);
         if(destPath.isEmpty())
             return;
-
-
-        // ------- temporarily copypasted from ImageStatic (needs refactoring)
-
-        QString tmpPath = destPath + "_" + QString(QCryptographicHash::hash(destPath.toUtf8(), QCryptographicHash::Md5).toHex());
         QFileInfo fi(destPath);
-        QString ext = fi.suffix();
-        int quality = 95;
-        if(ext.compare("png", Qt::CaseInsensitive) == 0)
-            quality = 30;
-        else if(ext.compare("jpg", Qt::CaseInsensitive) == 0 || ext.compare("jpeg", Qt::CaseInsensitive) == 0)
-            quality = settings->JPEGSaveQuality();
-
-        bool backupExists = false, success = false, originalExists = false;
-
-        if(QFile::exists(destPath))
-            originalExists = true;
-
-        // backup the original file if possible
-        if(originalExists) {
-            QFile::remove(tmpPath);
-            if(!QFile::copy(destPath, tmpPath)) {
-                qDebug() << "Could not create file backup.";
-                return;
-            }
-            backupExists = true;
-        }
-        // save file
-        success = image.save(destPath, ext.toStdString().c_str(), quality);
-
-        if(backupExists) {
-            if(success) {
-                // everything ok - remove the backup
-                QFile file(tmpPath);
-                file.remove();
-            } else if(originalExists) {
-                // revert on fail
-                QFile::remove(destPath);
-                QFile::copy(tmpPath, destPath);
-                QFile::remove(tmpPath);
-            }
-        }
-        // ------------------------------------------
+        bool success = ImageLib::saveRaw(&image, destPath, ImageLib::defaultSaveQuality(fi.suffix()));
         if(success)
             loadPath(destPath);
     }
@@ -672,6 +655,8 @@ FileOpResult Core::removeFile(QString filePath, bool trash) {
 }
 
 void Core::onFileRemoved(QString filePath, int index) {
+    if(shuffle)
+        randomizer.remove(filePath);
     // no files left
     if(model->isEmpty()) {
         mw->closeImage();
@@ -691,14 +676,17 @@ void Core::onFileRemoved(QString filePath, int index) {
     updateInfoString();
 }
 
-void Core::onFileRenamed(QString fromPath, int /*indexFrom*/, QString /*toPath*/, int indexTo) {
+void Core::onFileRenamed(QString fromPath, int /*indexFrom*/, QString toPath, int indexTo) {
+    if(shuffle)
+        randomizer.rename(fromPath, toPath);
     if(state.currentFilePath == fromPath) {
         loadFileIndex(indexTo, true, settings->usePreloader());
     }
 }
 
 void Core::onFileAdded(QString filePath) {
-    Q_UNUSED(filePath)
+    if(shuffle)
+        randomizer.insert(filePath);
     // update file count
     updateInfoString();
     if(model->fileCount() == 1 && state.currentFilePath == "")
@@ -756,42 +744,62 @@ void Core::showInDirectory() {
 #endif
 }
 
-void Core::interactiveCopy(QList<QString> paths, QString destDirectory) {
+// Conflicts are resolved up front, then the actual copying runs in the background
+void Core::startFileOperation(QList<QString> paths, QString destDirectory, bool move) {
+    QList<FileOpTask> tasks;
     DialogResult overwriteFiles;
+    // a running batch may have its own dirs queued for removal
+    int movedDirsBefore = movedDirs.size();
     for(auto path : paths) {
-        doInteractiveCopy(path, destDirectory, overwriteFiles);
-        if(overwriteFiles.cancel)
+        collectFileTasks(path, destDirectory, move, tasks, overwriteFiles);
+        if(overwriteFiles.cancel) {
+            // nothing was moved; keep the next operation from removing these
+            while(movedDirs.size() > movedDirsBefore)
+                movedDirs.removeLast();
             return;
+        }
     }
+    if(tasks.isEmpty()) {
+        removeMovedDirs();
+        return;
+    }
+    model->startFileOperations(tasks);
 }
 
 // todo: replacing DIR with a FILE?
-void Core::doInteractiveCopy(QString path, QString destDirectory, DialogResult &overwriteFiles) {
+void Core::collectFileTasks(QString path, QString destDirectory, bool move, QList<FileOpTask> &tasks, DialogResult &overwriteFiles) {
     QFileInfo srcFi(path);
-// SINGLE FILE COPY ===========================================================================
+// SINGLE FILE ================================================================================
     if(!srcFi.isDir()) {
-        FileOpResult result;
-        FileOperations::copyFileTo(path, destDirectory, overwriteFiles, result);
-        if(result == FileOpResult::DESTINATION_FILE_EXISTS) {
-            if(overwriteFiles.all) // skipping all
+        FileOpTask task;
+        task.srcPath = srcFi.absoluteFilePath();
+        task.destDirPath = destDirectory;
+        task.move = move;
+        task.size = srcFi.size();
+        QFileInfo dstFi(destDirectory + "/" + srcFi.fileName());
+        if(dstFi.exists()) {
+            if(dstFi.absoluteFilePath() == task.srcPath)
                 return;
-            overwriteFiles = mw->fileReplaceDialog(srcFi.absoluteFilePath(), destDirectory + "/" + srcFi.fileName(), FILE_TO_FILE, true);
-            if(!overwriteFiles || overwriteFiles.cancel)
+            if(!overwriteFiles.all) {
+                overwriteFiles = mw->fileReplaceDialog(srcFi.absoluteFilePath(), dstFi.absoluteFilePath(), FILE_TO_FILE, true);
+                if(overwriteFiles.cancel)
+                    return;
+            }
+            if(!overwriteFiles) // skipping
                 return;
-            FileOperations::copyFileTo(path, destDirectory, true, result);
-        }
-        if(result != FileOpResult::SUCCESS && !(result == FileOpResult::DESTINATION_FILE_EXISTS && !overwriteFiles)) {
-            mw->showError(FileOperations::decodeResult(result));
-            qDebug() << FileOperations::decodeResult(result);
+            task.force = true;
+            if(!overwriteFiles.all) // reset temporary flag
+                overwriteFiles.yes = false;
         }
-        if(!overwriteFiles.all) // copy attempt done; reset temporary flag
-            overwriteFiles.yes = false;
+        tasks.append(task);
         return;
     }
-// DIR COPY (RECURSIVE) =======================================================================
+// DIR (RECURSIVE) ============================================================================
     QDir srcDir(srcFi.absoluteFilePath());
-    QFileInfo dstFi(destDirectory + "/" + srcFi.baseName());
+    QFileInfo dstFi(destDirectory + "/" + srcFi.fileName());
     QDir dstDir(dstFi.absoluteFilePath());
+    if(srcDir.absolutePath() == dstDir.absolutePath())
+        return;
     if(dstFi.exists() && !dstFi.isDir()) { // overwriting file with a folder
         if(!overwriteFiles && !overwriteFiles.all) {
             overwriteFiles = mw->fileReplaceDialog(srcFi.absoluteFilePath(), dstFi.absoluteFilePath(), DIR_TO_FILE, true);
@@ -808,99 +816,77 @@ void Core::doInteractiveCopy(QString path, QString destDirectory, DialogResult &
             qDebug() << FileOperations::decodeResult(result);
             return;
         }
-    } else if(!dstDir.mkpath(".")) {
+    }
+    if(!dstDir.mkpath(".")) {
         mw->showError(tr("Could not create directory ") + dstDir.absolutePath());
         qDebug() << "Could not create directory " << dstDir.absolutePath();
         return;
     }
-    // copy all contents
     // TODO: skip symlinks? test
     QStringList entryList = srcDir.entryList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
     for(auto entry : entryList) {
-        doInteractiveCopy(srcDir.absolutePath() + "/" + entry, dstDir.absolutePath(), overwriteFiles);
+        collectFileTasks(srcDir.absolutePath() + "/" + entry, dstDir.absolutePath(), move, tasks, overwriteFiles);
         if(overwriteFiles.cancel)
             return;
     }
+    // children come first so removal goes bottom-up
+    if(move)
+        movedDirs.append(srcDir.absolutePath());
 }
-// -----------------------------------------------------------------------------------
 
-void Core::interactiveMove(QList<QString> paths, QString destDirectory) {
-    DialogResult overwriteFiles;
-    for(auto path : paths) {
-        doInteractiveMove(path, destDirectory, overwriteFiles);
-        if(overwriteFiles.cancel)
-            return;
+// empty source folders left behind after a move
+void Core::removeMovedDirs() {
+    for(auto dir : movedDirs) {
+        FileOpResult dirRmRes;
+        model->removeDir(dir, false, false, dirRmRes);
     }
+    movedDirs.clear();
 }
 
-// todo: replacing DIR with a FILE?
-void Core::doInteractiveMove(QString path, QString destDirectory, DialogResult &overwriteFiles) {
-    QFileInfo srcFi(path);
-// SINGLE FILE MOVE ===========================================================================
-    if(!srcFi.isDir()) {
-        FileOpResult result;
-        model->moveFileTo(path, destDirectory, overwriteFiles, result);
-        if(result == FileOpResult::DESTINATION_FILE_EXISTS) {
-            if(overwriteFiles.all) // skipping all
-                return;
-            overwriteFiles = mw->fileReplaceDialog(srcFi.absoluteFilePath(), destDirectory + "/" + srcFi.fileName(), FILE_TO_FILE, true);
-            if(!overwriteFiles || overwriteFiles.cancel)
-                return;
-            model->moveFileTo(path, destDirectory, true, result);
-        }
-        if(result != FileOpResult::SUCCESS && !(result == FileOpResult::DESTINATION_FILE_EXISTS && !overwriteFiles)) {
-            mw->showError(FileOperations::decodeResult(result));
-            qDebug() << FileOperations::decodeResult(result);
-        }
-        if(!overwriteFiles.all) // move attempt done; reset temporary flag
-            overwriteFiles.yes = false;
-        return;
-    }
-// DIR MOVE (RECURSIVE) =======================================================================
-    QDir srcDir(srcFi.absoluteFilePath());
-    QFileInfo dstFi(destDirectory + "/" + srcFi.baseName());
-    QDir dstDir(dstFi.absoluteFilePath());
-    if(dstFi.exists() && !dstFi.isDir()) { // overwriting file with a folder
-        if(!overwriteFiles && !overwriteFiles.all) {
-            overwriteFiles = mw->fileReplaceDialog(srcFi.absoluteFilePath(), dstFi.absoluteFilePath(), DIR_TO_FILE, true);
-            if(!overwriteFiles || overwriteFiles.cancel)
-                return;
-            if(!overwriteFiles.all) // reset temp flag right away
-                overwriteFiles.yes = false;
-        }
-        // remove dst file; give up if not writable
-        FileOpResult result;
-        FileOperations::removeFile(dstFi.absoluteFilePath(), result);
-        if(result != FileOpResult::SUCCESS) {
-            mw->showError(FileOperations::decodeResult(result));
-            qDebug() << FileOperations::decodeResult(result);
-            return;
-        }
-    } else if(!dstDir.mkpath(".")) {
-        mw->showError(tr("Could not create directory ") + dstDir.absolutePath());
-        qDebug() << "Could not create directory " << dstDir.absolutePath();
+void Core::onFileOperationsProgress(int done, int total, qint64 bytesPerSecond) {
+    QString text = tr("Processing files: ") + QString::number(done) + " / " + QString::number(total);
+    if(bytesPerSecond > 0)
+        text += "  (" + QString::number(bytesPerSecond / 1048576.0, 'f', 1) + " MB/s)";
+    mw->showFileOperationProgress(text, 1500);
+}
+
+void Core::onFileOperationsFinished(int succeeded, int failed, bool canceled, FileOpTask firstFailed) {
+    removeMovedDirs();
+    if(canceled) {
+        mw->showMessage(tr("File operation canceled. Processed: ") + QString::number(succeeded));
+    } else if(failed) {
+        QString error = QFileInfo(firstFailed.srcPath).fileName() + ": " + FileOperations::decodeResult(firstFailed.result);
+        if(failed > 1)
+            error = tr("Failed to process ") + QString::number(failed) + tr(" file(s)") + ". " + error;
+        mw->showError(error);
+        qDebug() << "[Core] file operation failed:" << firstFailed.srcPath << FileOperations::decodeResult(firstFailed.result);
+    } else
+        mw->showMessageSuccess(tr("Done: ") + QString::number(succeeded) + tr(" file(s)"));
+}
+
+void Core::cancelFileOperations() {
+    if(!model->fileOperationsBusy())
         return;
-    }
-    // move all contents
-    // TODO: skip symlinks? test
-    QStringList entryList = srcDir.entryList(QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot | QDir::Hidden | QDir::System);
-    for(auto entry : entryList) {
-        doInteractiveMove(srcDir.absolutePath() + "/" + entry, dstDir.absolutePath(), overwriteFiles);
-        if(overwriteFiles.cancel)
-            return;
-    }
-    FileOpResult dirRmRes;
-    model->removeDir(srcDir.absolutePath(), false, false, dirRmRes);
+    model->cancelFileOperations();
+    mw->showMessage(tr("Canceling..."));
+}
+
+// Esc stops a running copy / move first
+void Core::closeFullScreenOrExit() {
+    if(model && model->fileOperationsBusy())
+        cancelFileOperations();
+    else
+        mw->closeFullScreenOrExit();
 }
 
 // -----------------------------------------------------------------------------------
 
 void Core::copyPathsTo(QList<QString> paths, QString destDirectory) {
-    interactiveCopy(paths, destDirectory);
+    startFileOperation(paths, destDirectory, false);
 }
 
 void Core::movePathsTo(QList<QString> paths, QString destDirectory) {
-    interactiveMove(paths, destDirectory);
+    startFileOperation(paths, destDirectory, true);
 }
 
 void Core::moveCurrentFile(QString destDirectory) {
@@ -977,6 +963,18 @@ std::shared_ptr<ImageStatic> Core::getEditableImage(const QString &filePath) {
     return std::dynamic_pointer_cast<ImageStatic>(model->getImage(filePath));
 }
 
+// For anything that needs the full pixel data. Images decoded at display
+// size get the rest decoded on a worker first, so the gui thread never
+// waits for a full decode; action runs from onModelFullResolutionReady().
+void Core::withFullResolution(std::shared_ptr<Image> img, std::function<void()> action) {
+    if(!img || !img->isDownscaled()) {
+        action();
+        return;
+    }
+    fullResolutionActions[img->filePath()].append(action);
+    model->loadFullResolution(img);
+}
+
 template<typename... Args>
 void Core::edit_template(bool save, QString action, const std::function<QImage*(std::shared_ptr<const QImage>, Args...)>& editFunc, Args&&... as) {
     if(model->isEmpty())
@@ -987,15 +985,17 @@ void Core::edit_template(bool save, QString action, const std::function<QImage*(
         auto img = getEditableImage(path);
         if(!img)
             continue;
-        img->setEditedImage(std::unique_ptr<const QImage>( editFunc(img->getImage(), std::forward<Args>(as)...) ));
-        model->updateImage(path, std::static_pointer_cast<Image>(img));
-        if(save) {
-            saveFile(path);
-            if(state.currentFilePath != path)
-                model->unload(path);
-        }
+        withFullResolution(img, [=]() mutable {
+            img->setEditedImage(std::unique_ptr<const QImage>( editFunc(img->getImage(), as...) ));
+            model->updateImage(path, std::static_pointer_cast<Image>(img));
+            if(save) {
+                saveFile(path);
+                if(state.currentFilePath != path)
+                    model->unload(path);
+            }
+            updateInfoString();
+        });
     }
-    updateInfoString();
 }
 
 void Core::flipH() {
@@ -1021,11 +1021,15 @@ void Core::crop(QRect rect) {
 }
 
 void Core::cropAndSave(QRect rect) {
-    if(mw->currentViewMode() == MODE_FOLDERVIEW)
+    if(mw->currentViewMode() == MODE_FOLDERVIEW || model->isEmpty())
         return;
-    edit_template(false, tr("Crop"), { ImageLib::cropped }, rect);
-    saveFile(selectedPath());
-    updateInfoString();
+    QString path = selectedPath();
+    // so the crop below is applied right away
+    withFullResolution(getEditableImage(path), [this, path, rect]() {
+        edit_template(false, tr("Crop"), { ImageLib::cropped }, rect);
+        saveFile(path);
+        updateInfoString();
+    });
 }
 
 // ---------------------------------------------------------------- image operations ^
@@ -1034,16 +1038,12 @@ bool Core::saveFile(const QString &filePath) {
     return saveFile(filePath, filePath);
 }
 
+// encoded in background, the rest happens in onModelSaveFinished()
 bool Core::saveFile(const QString &filePath, const QString &newPath) {
     if(!model->saveFile(filePath, newPath))
         return false;
     mw->hideSaveOverlay();
-    // switch to the new file
-    if(model->containsFile(newPath) && state.currentFilePath != newPath) {
-        discardEdits();
-        if(mw->currentViewMode() == MODE_DOCUMENT)
-            loadPath(newPath);
-    }
+    showSaveProgress();
     return true;
 }
 
@@ -1054,12 +1054,43 @@ void Core::saveCurrentFile() {
 void Core::saveCurrentFileAs(QString destPath) {
     if(model->isEmpty())
         return;
-    if(saveFile(selectedPath(), destPath)) {
-        mw->showMessageSuccess(tr("File saved"));
+    if(saveFile(selectedPath(), destPath))
         updateInfoString();
-    } else {
+    else
+        mw->showError(tr("Could not save file"));
+}
+
+void Core::showSaveProgress() {
+    // don't hide an error behind it
+    if(state.failedSaves)
+        return;
+    QString text = tr("Saving...");
+    int pending = model->pendingSaves();
+    if(pending > 1)
+        text += "  (" + QString::number(pending) + ")";
+    mw->showMessage(text, SAVE_MESSAGE_DURATION);
+}
+
+void Core::onModelSaveFinished(QString sourcePath, QString destPath, bool success) {
+    if(!success) {
+        state.failedSaves++;
         mw->showError(tr("Could not save file"));
     }
+    if(model->saveBusy()) {
+        showSaveProgress();
+    } else {
+        if(!state.failedSaves)
+            mw->showMessageSuccess(tr("File saved"));
+        state.failedSaves = 0;
+    }
+    // switch to the new file, unless the user went somewhere else meanwhile
+    if(success && sourcePath != destPath && state.currentFilePath == sourcePath &&
+       mw->currentViewMode() == MODE_DOCUMENT && model->containsFile(destPath))
+    {
+        loadPath(destPath);
+        return;
+    }
+    updateInfoString();
 }
 
 void Core::discardEdits() {
@@ -1165,7 +1196,6 @@ void Core::setWallpaper() {
 void Core::print() {
     if(model->isEmpty())
         return;
-    PrintDialog p(mw);
     auto img = model->getImage(selectedPath());
     if(!img) {
         mw->showError(tr("Could not open image"));
@@ -1176,14 +1206,18 @@ void Core::print() {
         return;
     }
     QString pdfPath = model->directoryPath() + "/" + img->baseName() + ".pdf";
-    p.setImage(img->getImage());
-    p.setOutputPath(pdfPath);
-    p.exec();
+    withFullResolution(img, [this, img, pdfPath]() {
+        PrintDialog p(mw);
+        p.setImage(img->getImage());
+        p.setOutputPath(pdfPath);
+        p.exec();
+    });
 }
 
 void Core::scalingRequest(QSize size, ScalingFilter filter) {
     // filter out an unnecessary scale request at statup
-    if(mw->isVisible() && state.hasActiveImage) {
+    // and don't decode anything for a navigation preview
+    if(mw->isVisible() && state.hasActiveImage && !state.previewOnly) {
         std::shared_ptr<Image> forScale = model->getImage(state.currentFilePath);
         if(forScale) {
             model->scaler->requestScaled(ScalerRequest(forScale, size, state.currentFilePath, filter));
@@ -1203,6 +1237,8 @@ void Core::onScalingFinished(QPixmap *scaled, ScalerRequest req) {
 // reset state; clear cache; etc
 void Core::reset() {
     state.hasActiveImage = false;
+    state.previewOnly = false;
+    navigationSettleTimer.stop();
     state.currentFilePath = "";
     model->setDirectory("");
 }
@@ -1265,19 +1301,44 @@ bool Core::setDirectory(QString path) {
     return true;
 }
 
+// files we'll likely go to next; in shuffle mode that is the randomizer order
+QStringList Core::preloadTargets(QString filePath) {
+    QStringList list;
+    if(shuffle) {
+        list << randomizer.peekNext();
+        list << randomizer.peekPrev();
+    } else {
+        list << model->nextOf(filePath);
+        list << model->prevOf(filePath);
+    }
+    list.removeAll("");
+    list.removeAll(filePath);
+    return list;
+}
+
 bool Core::loadFileIndex(int index, bool async, bool preload) {
     if(!model)
         return false;
     auto entry = model->fileEntryAt(index);
     if(entry.path.isEmpty())
         return false;
+    navigationSettleTimer.stop();
     state.currentFilePath = entry.path;
-    model->unloadExcept(entry.path, preload);
+    state.loadStarted = PerfTrace::enabled() ? PerfTrace::getInstance()->now() : -1;
+    if(shuffle)
+        randomizer.setCurrent(entry.path);
+    QStringList nearby;
+    if(preload)
+        nearby = preloadTargets(entry.path);
+    model->unloadExcept(entry.path, nearby);
+    // decode only what fits on screen; the rest is loaded when zooming in
+    if(settings->decodeAtDisplaySize() && mw->isVisible())
+        model->setDisplaySize(mw->fitWindowTargetSize());
+    else
+        model->setDisplaySize(QSize());
     model->load(entry.path, async);
-    if(preload) {
-        model->preload(model->nextOf(entry.path));
-        model->preload(model->prevOf(entry.path));
-    }
+    for(auto &path : nearby)
+        model->preload(path);
     thumbPanelPresenter.selectAndFocus(entry.path);
     folderViewPresenter.selectAndFocus(entry.path);
     updateInfoString();
@@ -1354,7 +1415,7 @@ void Core::nextImage() {
         return;
     stopSlideshow();
     if(shuffle) {
-        loadFileIndex(randomizer.next(), true, false);
+        navigateTo(model->indexOfFile(randomizer.next()));
         return;
     }
     int newIndex = model->indexOfFile(state.currentFilePath) + 1;
@@ -1370,7 +1431,7 @@ void Core::nextImage() {
             return;
         }
     }
-    loadFileIndex(newIndex, true, settings->usePreloader());
+    navigateTo(newIndex);
 }
 
 void Core::prevImage() {
@@ -1378,7 +1439,7 @@ void Core::prevImage() {
         return;
     stopSlideshow();
     if(shuffle) {
-        loadFileIndex(randomizer.prev(), true, false);
+        navigateTo(model->indexOfFile(randomizer.prev()));
         return;
     }
 
@@ -1395,14 +1456,71 @@ void Core::prevImage() {
             return;
         }
     }
-    loadFileIndex(newIndex, true, settings->usePreloader());
+    navigateTo(newIndex);
+}
+
+// Holding next/prev steps faster than anything can be decoded, and every
+// full load would cancel the one before it. So once steps come in quickly
+// we only move the selection and show a thumbnail-sized preview; the one
+// real load (with preloading around it) starts when stepping stops.
+void Core::navigateTo(int index) {
+    bool rapid = navigationSettleTimer.isActive() ||
+                 (navigationTimer.isValid() && navigationTimer.elapsed() < NAVIGATION_REPEAT_INTERVAL);
+    navigationTimer.restart();
+    if(!rapid) {
+        loadFileIndex(index, true, settings->usePreloader());
+        return;
+    }
+    auto entry = model->fileEntryAt(index);
+    if(entry.path.isEmpty())
+        return;
+    navigationSettleTimer.start();
+    state.currentFilePath = entry.path;
+    if(shuffle)
+        randomizer.setCurrent(entry.path);
+    thumbPanelPresenter.selectAndFocus(entry.path);
+    folderViewPresenter.selectAndFocus(entry.path);
+    // skipped positions don't need their previews anymore
+    previewer.clearTasks();
+    if(model->isLoaded(entry.path)) {
+        // preloaded neighbour or still cached; as cheap as it gets
+        state.currentImg = model->getImage(entry.path);
+        guiSetImage(state.currentImg);
+    } else {
+        state.previewOnly = true;
+        // the previous image is still around; nothing should act on it
+        state.currentImg.reset();
+        mw->setExifInfo(QMap<QString, QString>());
+        previewer.getThumbnailAsync(entry.path, NAVIGATION_PREVIEW_SIZE, false, false);
+    }
+    updateInfoString();
+}
+
+void Core::onNavigationSettled() {
+    int index = model->indexOfFile(state.currentFilePath);
+    if(index < 0)
+        return;
+    state.settling = true;
+    loadFileIndex(index, true, settings->usePreloader());
+    state.settling = false;
+}
+
+void Core::onPreviewReady(std::shared_ptr<Thumbnail> thumbnail, QString filePath) {
+    // the real image may have arrived first
+    if(!state.previewOnly || filePath != state.currentFilePath || !thumbnail || !thumbnail->pixmap())
+        return;
+    if(mw->currentViewMode() != MODE_DOCUMENT)
+        return;
+    // laid out at the source size, so the real image replaces it in place
+    mw->showImage(std::make_unique<QPixmap>(*thumbnail->pixmap()), thumbnail->originalSize());
 }
 
 void Core::nextImageSlideshow() {
     if(model->isEmpty() || mw->currentViewMode() == MODE_FOLDERVIEW)
         return;
+    // always preload here: the next image gets decoded and scaled while this one is shown
     if(shuffle) {
-        loadFileIndex(randomizer.next(), false, false);
+        loadFileIndex(model->indexOfFile(randomizer.next()), false, true);
     } else {
         int newIndex = model->indexOfFile(state.currentFilePath) + 1;
         if(newIndex >= model->fileCount()) {
@@ -1456,25 +1574,83 @@ void Core::onLoadFailed(const QString &path) {
 
 void Core::onModelItemReady(std::shared_ptr<Image> img, const QString &path) {
     if(path == state.currentFilePath) {
-        state.currentImg = img;
-        guiSetImage(img);
+        // a cached target is already on screen since navigateTo()
+        if(state.settling && img == state.currentImg && !state.previewOnly) {
+            state.loadStarted = -1;
+        } else {
+            state.currentImg = img;
+            guiSetImage(img);
+        }
         updateInfoString();
         if(state.delayModel) {
             this->showGui();
             state.delayModel = false;
             QTimer::singleShot(40, this, SLOT(modelDelayLoad()));
         }
-        model->unloadExcept(state.currentFilePath, settings->usePreloader());
+        QStringList nearby;
+        if(settings->usePreloader() || slideshow)
+            nearby = preloadTargets(state.currentFilePath);
+        model->unloadExcept(state.currentFilePath, nearby);
+    } else {
+        // anything else that arrives was preloaded
+        prescale(img);
+        // one spare player: give it the clip we'd go to next
+        if(img->type() == VIDEO && preloadTargets(state.currentFilePath).value(0) == path)
+            mw->preloadVideo(path);
     }
 }
 
+// fit-window rendition for a preloaded neighbour, so it shows up sharp right away
+void Core::prescale(std::shared_ptr<Image> img) {
+    if(!img || img->type() != STATIC || !mw->isVisible())
+        return;
+    QSize size = mw->fitWindowScaledSize(img->size());
+    if(size.isEmpty())
+        return;
+    model->scaler->prescale(ScalerRequest(img, size, img->filePath(), mw->scalingFilter()));
+}
+
 void Core::modelDelayLoad() {
     model->setDirectory(state.directoryPath);
     mw->setDirectoryPath(state.directoryPath);
-    model->updateImage(state.currentFilePath, state.currentImg);
+    if(state.currentImg)
+        model->updateImage(state.currentFilePath, state.currentImg);
     updateInfoString();
 }
 
+void Core::onFullResolutionRequested() {
+    if(state.hasActiveImage && !state.previewOnly)
+        model->loadFullResolution(state.currentFilePath);
+}
+
+void Core::onModelFullResolutionReady(QString filePath) {
+    if(filePath == state.currentFilePath && mw->currentViewMode() == MODE_DOCUMENT && model->isLoaded(filePath)) {
+        auto img = model->getImage(filePath);
+        if(img && img->type() == STATIC && !img->isEdited())
+            mw->replaceSourcePixmap(img->getPixmap(), img->size());
+    }
+    for(auto &action : fullResolutionActions.take(filePath))
+        action();
+}
+
+void Core::onModelExifTagsReady(QString filePath, QMap<QString, QString> tags) {
+    if(filePath == state.currentFilePath)
+        setImageInfo(model->isLoaded(filePath) ? model->getImage(filePath) : nullptr, tags);
+}
+
+// exif tags, plus playback info for animations
+void Core::setImageInfo(std::shared_ptr<Image> img, QMap<QString, QString> tags) {
+    if(img && img->type() == ANIMATED) {
+        auto animated = dynamic_cast<ImageAnimated *>(img.get());
+        tags.insert(tr("Frames"), QString::number(animated->frameCount()));
+        // known once every frame went through the decoder
+        int duration = animated->duration();
+        if(duration > 0)
+            tags.insert(tr("Duration"), QString::number(duration / 1000.0, 'f', 2) + " s");
+    }
+    mw->setExifInfo(tags);
+}
+
 void Core::onModelItemUpdated(QString filePath) {
     if(filePath == state.currentFilePath) {
         guiSetImage(model->getImage(filePath));
@@ -1490,18 +1666,33 @@ void Core::onModelSortingChanged(SortingMode mode) {
     folderViewPresenter.selectAndFocus(state.currentFilePath);
 }
 
+// same, without the message; happens while the metadata index fills up
+void Core::onModelListChanged() {
+    thumbPanelPresenter.reloadModel();
+    thumbPanelPresenter.selectAndFocus(state.currentFilePath);
+    folderViewPresenter.reloadModel();
+    folderViewPresenter.selectAndFocus(state.currentFilePath);
+    updateInfoString();
+}
+
 void Core::guiSetImage(std::shared_ptr<Image> img) {
     state.hasActiveImage = true;
+    state.previewOnly = false;
     if(!img) {
         mw->showMessage(tr("Error: could not load image."));
         return;
     }
     DocumentType type = img->type();
     if(type == STATIC) {
-        mw->showImage(img->getPixmap());
+        std::unique_ptr<QPixmap> pixmap;
+        {
+            PerfScope scope("pixmap", img->filePath());
+            pixmap = img->getPixmap();
+        }
+        mw->showImage(std::move(pixmap), img->size());
     } else if(type == ANIMATED) {
         auto animated = dynamic_cast<ImageAnimated *>(img.get());
-        mw->showAnimation(animated->getMovie());
+        mw->showAnimation(animated->getAnimation());
     } else if(type == VIDEO) {
         auto video = dynamic_cast<Video *>(img.get());
         // workaround for mpv. If we play video while mainwindow is hidden we get black screen.
@@ -1509,8 +1700,20 @@ void Core::guiSetImage(std::shared_ptr<Image> img) {
         showGui();
         mw->showVideo(video->filePath());
     }
+    // request -> on screen, including any wait for the loader
+    if(state.loadStarted >= 0 && PerfTrace::enabled()) {
+        auto trace = PerfTrace::getInstance();
+        trace->addEvent("display", img->filePath(), state.loadStarted, trace->now() - state.loadStarted);
+    }
+    state.loadStarted = -1;
     img->isEdited() ? mw->showSaveOverlay() : mw->hideSaveOverlay();
-    mw->setExifInfo(img->getExifTags());
+    if(img->exifTagsLoaded()) {
+        setImageInfo(img, img->getExifTags());
+    } else {
+        // don't hit the disk on gui thread; shows up in onModelExifTagsReady()
+        setImageInfo(img, QMap<QString, QString>());
+        model->loadExifTags(img->filePath());
+    }
 }
 
 void Core::updateInfoString() {
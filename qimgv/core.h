@@ -13,8 +13,10 @@
 #include "components/directorymodel.h"
 #include "components/directorypresenter.h"
 #include "components/scriptmanager/scriptmanager.h"
+#include "components/thumbnailer/thumbnailer.h"
 #include "gui/mainwindow.h"
 #include "utils/randomizer.h"
+#include "utils/perftrace.h"
 #include "gui/dialogs/printdialog.h"
 
 #ifdef __GLIBC__
@@ -27,6 +29,10 @@ struct State {
     QString currentFilePath = "";
     QString directoryPath = "";
     std::shared_ptr<Image> currentImg;
+    qint64 loadStarted = -1; // PerfTrace time of the last loadFileIndex()
+    bool previewOnly = false; // a navigation preview is on screen, not the image itself
+    bool settling = false; // onNavigationSettled() in progress
+    int failedSaves = 0; // since the save queue was last empty
 };
 
 enum MimeDataTarget {
@@ -81,8 +87,15 @@ private:
     void attachModel(DirectoryModel *_model);
     QString selectedPath();
     void guiSetImage(std::shared_ptr<Image> img);
+    void setImageInfo(std::shared_ptr<Image> img, QMap<QString, QString> tags);
     QTimer slideshowTimer;
 
+    // navigation coalescing (key auto-repeat)
+    QElapsedTimer navigationTimer;
+    QTimer navigationSettleTimer;
+    Thumbnailer previewer;
+    void navigateTo(int index);
+
     void startSlideshowTimer();
     void startSlideshow();
     void stopSlideshow();
@@ -92,12 +105,17 @@ private:
 
     std::shared_ptr<ImageStatic> getEditableImage(const QString &filePath);
     QList<QString> currentSelection();
+    void withFullResolution(std::shared_ptr<Image> img, std::function<void()> action);
+    // waiting for onModelFullResolutionReady(), by file path
+    QHash<QString, QList<std::function<void()>>> fullResolutionActions;
 
     template<typename... Args>
     void edit_template(bool save, QString actionName, const std::function<QImage*(std::shared_ptr<const QImage>, Args...)>& func, Args&&... as);
 
-    void doInteractiveCopy(QString path, QString destDirectory, DialogResult &overwriteAllFiles);
-    void doInteractiveMove(QString path, QString destDirectory, DialogResult &overwriteAllFiles);
+    void startFileOperation(QList<QString> paths, QString destDirectory, bool move);
+    void collectFileTasks(QString path, QString destDirectory, bool move, QList<FileOpTask> &tasks, DialogResult &overwriteFiles);
+    QList<QString> movedDirs;
+    void removeMovedDirs();
 
 private slots:
     void readSettings();
@@ -108,18 +126,29 @@ private slots:
     void jumpToLast();
     void onModelItemReady(std::shared_ptr<Image>, const QString&);
     void onModelItemUpdated(QString fileName);
+    void onModelExifTagsReady(QString filePath, QMap<QString, QString> tags);
+    void onNavigationSettled();
+    void onPreviewReady(std::shared_ptr<Thumbnail> thumbnail, QString filePath);
+    void onFullResolutionRequested();
+    void onModelFullResolutionReady(QString filePath);
     void onModelSortingChanged(SortingMode mode);
+    void onModelListChanged();
     void onLoadFailed(const QString &path);
     void rotateLeft();
     void rotateRight();
     void close();
     void scalingRequest(QSize, ScalingFilter);
+    void prescale(std::shared_ptr<Image> img);
     void onScalingFinished(QPixmap* scaled, ScalerRequest req);
     void copyCurrentFile(QString destDirectory);
     void moveCurrentFile(QString destDirectory);
     void copyPathsTo(QList<QString> paths, QString destDirectory);
-    void interactiveCopy(QList<QString> paths, QString destDirectory);
-    void interactiveMove(QList<QString> paths, QString destDirectory);
+    void onFileOperationsProgress(int done, int total, qint64 bytesPerSecond);
+    void onFileOperationsFinished(int succeeded, int failed, bool canceled, FileOpTask firstFailed);
+    void cancelFileOperations();
+    void closeFullScreenOrExit();
+    void showSaveProgress();
+    void onModelSaveFinished(QString sourcePath, QString destPath, bool success);
     void movePathsTo(QList<QString> paths, QString destDirectory);
     FileOpResult removeFile(QString fileName, bool trash);
     void onFileRemoved(QString filePath, int index);
@@ -163,6 +192,7 @@ private slots:
     void showInDirectory();
     void onDirectoryViewFileActivated(QString filePath);
     bool loadFileIndex(int index, bool async, bool preload);
+    QStringList preloadTargets(QString filePath);
     void enableDocumentView();
     void enableFolderView();
     void toggleFolderView();
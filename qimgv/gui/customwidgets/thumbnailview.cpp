@@ -333,7 +333,7 @@ void ThumbnailView::reloadItem(int index) {
     auto thumb = thumbnails.at(index);
     if(thumb->isLoaded)
         thumb->unsetThumbnail();
-    emit thumbnailsRequested(QList<int>() << index, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, true);
+    emit thumbnailsRequested(QList<int>() << index, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, true, 1);
 }
 
 void ThumbnailView::setDragHover(int index) {
@@ -386,10 +386,12 @@ void ThumbnailView::loadVisibleThumbnails() {
             visibleItems = scene.items(visRect, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder);
         else
             visibleItems = scene.items(visRect, Qt::IntersectsItemBoundingRect, Qt::DescendingOrder);
+        int onscreenCount = visibleItems.count();
         visibleItems.append(scene.items(offRectBack,  Qt::IntersectsItemBoundingRect, Qt::DescendingOrder));
         visibleItems.append(scene.items(offRectFront, Qt::IntersectsItemBoundingRect, Qt::AscendingOrder));
         // select
         QList<int> loadList;
+        int loadOnscreen = 0; // these go first in loadList
         for(int i = 0; i < visibleItems.count(); i++) {
             ThumbnailWidget* widget = qgraphicsitem_cast<ThumbnailWidget*>(visibleItems.at(i));
             if(widget && !widget->isLoaded) {
@@ -397,10 +399,12 @@ void ThumbnailView::loadVisibleThumbnails() {
                 if(!loadList.contains(idx))
                     loadList.append(idx);
             }
+            if(i == onscreenCount - 1)
+                loadOnscreen = loadList.count();
         }
         // load
         if(loadList.count())
-            emit thumbnailsRequested(loadList, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, false);
+            emit thumbnailsRequested(loadList, static_cast<int>(qApp->devicePixelRatio() * mThumbnailSize), mCropThumbnails, false, loadOnscreen);
         // unload offscreen
         if(settings->unloadThumbs()) {
             for(int i = 0; i < thumbnails.count(); i++)
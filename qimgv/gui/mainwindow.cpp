@@ -12,6 +12,7 @@ MW::MW(QWidget *parent)
       renameOverlay(nullptr),
       infoBarFullscreen(nullptr),
       imageInfoOverlay(nullptr),
+      perfOverlay(nullptr),
       floatingMessage(nullptr),
       cropPanel(nullptr),
       cropOverlay(nullptr)
@@ -76,7 +77,9 @@ void MW::setupUi() {
     layout.addWidget(sidePanel);
     imageInfoOverlay = new ImageInfoOverlayProxy(viewerWidget.get());
     floatingMessage = new FloatingMessageProxy(viewerWidget.get()); // todo: use additional one for folderview?
+    connect(floatingMessage, &FloatingMessageProxy::actionClicked, this, &MW::cancelFileOperationsRequested);
     connect(viewerWidget.get(), &ViewerWidget::scalingRequested, this, &MW::scalingRequested);
+    connect(viewerWidget.get(), &ViewerWidget::fullResolutionRequested, this, &MW::fullResolutionRequested);
     connect(viewerWidget.get(), &ViewerWidget::draggedOut, this, qOverload<>(&MW::draggedOut));
     connect(viewerWidget.get(), &ViewerWidget::playbackFinished, this, &MW::playbackFinished);
     connect(viewerWidget.get(), &ViewerWidget::showScriptSettings, this, &MW::showScriptSettings);
@@ -107,6 +110,9 @@ void MW::setupFullUi() {
     docWidget->setupMainPanel();
     infoBarWindowed->init();
     infoBarFullscreen->init();
+    // so the first video doesn't have to wait for it
+    if(settings->videoPlayback())
+        QTimer::singleShot(500, viewerWidget.get(), &ViewerWidget::preinitVideoPlayer);
 }
 
 void MW::setupCropPanel() {
@@ -134,6 +140,10 @@ void MW::setupSaveOverlay() {
     connect(saveOverlay, &SaveConfirmOverlay::discardClicked, this, &MW::discardEditsRequested);
 }
 
+void MW::setupPerfOverlay() {
+    perfOverlay = new PerfOverlay(viewerWidget.get());
+}
+
 void MW::setupRenameOverlay() {
     renameOverlay = new RenameOverlay(this);
     renameOverlay->setName(info.fileName);
@@ -240,17 +250,19 @@ void MW::preShowResize(QSize sz) {
     qApp->processEvents(); // not needed anymore with patched qt?
 }
 
-void MW::showImage(std::unique_ptr<QPixmap> pixmap) {
+void MW::showImage(std::unique_ptr<QPixmap> pixmap, QSize sourceSize) {
+    if(sourceSize.isEmpty())
+        sourceSize = pixmap->size();
     if(settings->autoResizeWindow())
-        preShowResize(pixmap->size());
-    viewerWidget->showImage(std::move(pixmap));
+        preShowResize(sourceSize);
+    viewerWidget->showImage(std::move(pixmap), sourceSize);
     updateCropPanelData();
 }
 
-void MW::showAnimation(std::shared_ptr<QMovie> movie) {
+void MW::showAnimation(std::shared_ptr<AnimationDecoder> animation) {
     if(settings->autoResizeWindow())
-        preShowResize(movie->frameRect().size());
-    viewerWidget->showAnimation(movie);
+        preShowResize(animation->size());
+    viewerWidget->showAnimation(animation);
     updateCropPanelData();
 }
 
@@ -260,6 +272,14 @@ void MW::showVideo(QString file) {
     viewerWidget->showVideo(file);
 }
 
+void MW::preloadVideo(QString file) {
+    viewerWidget->preloadVideo(file);
+}
+
+void MW::releaseVideoPreload() {
+    viewerWidget->releaseVideoPreload();
+}
+
 void MW::showContextMenu() {
     viewerWidget->showContextMenu();
 }
@@ -274,12 +294,20 @@ void MW::onSortingChanged(SortingMode mode) {
             case SortingMode::SORT_TIME_DESC: showMessage("Sorting: By Time (desc.)");      break;
             case SortingMode::SORT_SIZE:      showMessage("Sorting: By File Size");         break;
             case SortingMode::SORT_SIZE_DESC: showMessage("Sorting: By File Size (desc.)"); break;
+            case SortingMode::SORT_CAPTURE_TIME:      showMessage("Sorting: By Date Taken");          break;
+            case SortingMode::SORT_CAPTURE_TIME_DESC: showMessage("Sorting: By Date Taken (desc.)");  break;
+            case SortingMode::SORT_RESOLUTION:        showMessage("Sorting: By Resolution");          break;
+            case SortingMode::SORT_RESOLUTION_DESC:   showMessage("Sorting: By Resolution (desc.)");  break;
+            case SortingMode::SORT_TYPE:              showMessage("Sorting: By Type");                break;
         }
     }
 }
 
 void MW::setDirectoryPath(QString path) {
     //closeImage();
+    // the next clip is from the old folder
+    if(path != info.directoryPath)
+        releaseVideoPreload();
     info.directoryPath = path;
     info.directoryName = path.split("/").last();
     folderView->setDirectoryPath(path);
@@ -323,6 +351,15 @@ void MW::toggleImageInfoOverlay() {
         imageInfoOverlay->hide();
 }
 
+void MW::togglePerfOverlay() {
+    if(!perfOverlay)
+        setupPerfOverlay();
+    if(perfOverlay->isHidden())
+        perfOverlay->show();
+    else
+        perfOverlay->hide();
+}
+
 void MW::toggleRenameOverlay(QString currentName) {
     if(!renameOverlay)
         setupRenameOverlay();
@@ -389,6 +426,22 @@ void MW::onScalingFinished(std::unique_ptr<QPixmap> scaled) {
     viewerWidget->onScalingFinished(std::move(scaled));
 }
 
+QSize MW::fitWindowScaledSize(QSize source) {
+    return viewerWidget->fitWindowScaledSize(source);
+}
+
+QSize MW::fitWindowTargetSize() {
+    return viewerWidget->fitWindowTargetSize();
+}
+
+void MW::replaceSourcePixmap(std::unique_ptr<QPixmap> pixmap, QSize sourceSize) {
+    viewerWidget->replaceSourcePixmap(std::move(pixmap), sourceSize);
+}
+
+ScalingFilter MW::scalingFilter() {
+    return viewerWidget->scalingFilter();
+}
+
 void MW::saveWindowGeometry() {
     if(this->windowState() == Qt::WindowNoState)
         settings->setWindowGeometry(geometry());
@@ -887,6 +940,11 @@ void MW::showMessageSuccess(QString text) {
     floatingMessage->showMessage(text,  FloatingMessageIcon::ICON_SUCCESS, 1500);
 }
 
+// same as showMessage() plus a cancel button
+void MW::showFileOperationProgress(QString text, int duration) {
+    floatingMessage->showMessage(text, FloatingMessageIcon::NO_ICON, duration, tr("Cancel"));
+}
+
 void MW::showWarning(QString text) {
     floatingMessage->showMessage(text,  FloatingMessageIcon::ICON_WARNING, 1500);
 }
@@ -27,6 +27,7 @@
 #include "gui/overlays/changelogwindow.h"
 #include "gui/overlays/imageinfooverlayproxy.h"
 #include "gui/overlays/renameoverlay.h"
+#include "gui/overlays/perfoverlay.h"
 #include "gui/dialogs/resizedialog.h"
 #include "gui/centralwidget.h"
 #include "gui/dialogs/filereplacedialog.h"
@@ -67,9 +68,15 @@ public:
     explicit MW(QWidget *parent = nullptr);
     bool isCropPanelActive();
     void onScalingFinished(std::unique_ptr<QPixmap>scaled);
-    void showImage(std::unique_ptr<QPixmap> pixmap);
-    void showAnimation(std::shared_ptr<QMovie> movie);
+    QSize fitWindowScaledSize(QSize source);
+    ScalingFilter scalingFilter();
+    void showImage(std::unique_ptr<QPixmap> pixmap, QSize sourceSize = QSize());
+    void replaceSourcePixmap(std::unique_ptr<QPixmap> pixmap, QSize sourceSize);
+    QSize fitWindowTargetSize();
+    void showAnimation(std::shared_ptr<AnimationDecoder> animation);
     void showVideo(QString file);
+    void preloadVideo(QString file);
+    void releaseVideoPreload();
 
     void setCurrentInfo(int fileIndex, int fileCount, QString filePath, QString fileName, QSize imageSize, qint64 fileSize, bool slideshow, bool shuffle, bool edited);
     void setExifInfo(QMap<QString, QString>);
@@ -104,6 +111,8 @@ private:
 
     ImageInfoOverlayProxy *imageInfoOverlay;
 
+    PerfOverlay *perfOverlay;
+
     ControlsOverlay *controlsOverlay;
     FullscreenInfoOverlayProxy *infoBarFullscreen;
     std::shared_ptr<InfoBarProxy> infoBarWindowed;
@@ -128,6 +137,7 @@ private:
     void setupCopyOverlay();
     void setupSaveOverlay();
     void setupRenameOverlay();
+    void setupPerfOverlay();
     void preShowResize(QSize sz);
     void setInteractionEnabled(bool mode);
 
@@ -162,6 +172,7 @@ signals:
     void moveRequested(QString);
     void copyUrlsRequested(QList<QString>, QString);
     void moveUrlsRequested(QList<QString>, QString);
+    void cancelFileOperationsRequested();
     void showFoldersChanged(bool);
     void resizeRequested(QSize);
     void renameRequested(QString);
@@ -175,6 +186,7 @@ signals:
 
     // viewerWidget
     void scalingRequested(QSize, ScalingFilter);
+    void fullResolutionRequested();
     void zoomIn();
     void zoomOut();
     void zoomInCursor();
@@ -224,6 +236,7 @@ public slots:
     void showMessage(QString text);
     void showMessage(QString text, int duration);
     void showMessageSuccess(QString text);
+    void showFileOperationProgress(QString text, int duration);
     void showWarning(QString text);
     void showError(QString text);
     void triggerMoveOverlay();
@@ -243,6 +256,7 @@ public slots:
     void showContextMenu();
     void onSortingChanged(SortingMode);
     void toggleImageInfoOverlay();
+    void togglePerfOverlay();
     void toggleRenameOverlay(QString currentName);
     void setFilterNearest();
     void setFilterBilinear();
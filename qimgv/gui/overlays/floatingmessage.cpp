@@ -16,6 +16,8 @@ FloatingMessage::FloatingMessage(FloatingWidgetContainer *parent) :
     setFadeDuration(300);
 
     setIcon(FloatingMessageIcon::NO_ICON);
+    ui->actionButton->hide();
+    connect(ui->actionButton, &QPushButton::clicked, this, &FloatingMessage::actionClicked);
 
     this->setAccessibleName("FloatingMessage");
     connect(&visibilityTimer, &QTimer::timeout, this, &FloatingMessage::hideAnimated);
@@ -48,14 +50,16 @@ void FloatingMessage::showMessage(QString text, FloatingWidgetPosition position,
     doShowMessage(text, icon, duration);
 }
 
-void FloatingMessage::showMessage(QString text, FloatingMessageIcon icon, int duration) {
+void FloatingMessage::showMessage(QString text, FloatingMessageIcon icon, int duration, QString actionText) {
     setPosition(preferredPosition);
-    doShowMessage(text, icon, duration);
+    doShowMessage(text, icon, duration, actionText);
 }
 
-void FloatingMessage::doShowMessage(QString text, FloatingMessageIcon icon, int duration) {
+void FloatingMessage::doShowMessage(QString text, FloatingMessageIcon icon, int duration, QString actionText) {
     hideDelay = duration;
     setIcon(icon);
+    ui->actionButton->setText(actionText);
+    ui->actionButton->setHidden(actionText.isEmpty());
     setText(text);
     show();
 }
@@ -24,19 +24,23 @@ class FloatingMessage : public OverlayWidget {
 public:
     FloatingMessage(FloatingWidgetContainer *parent);
     ~FloatingMessage();
-    void showMessage(QString text, FloatingMessageIcon icon, int fadeDuration);
+    // actionText: label for a button next to the text; hidden when empty
+    void showMessage(QString text, FloatingMessageIcon icon, int fadeDuration, QString actionText = "");
     void showMessage(QString text, FloatingWidgetPosition position, FloatingMessageIcon icon, int duration);
 
 public slots:
     void show();
     void setText(QString text);
 
+signals:
+    void actionClicked();
+
 private:
     QTimer visibilityTimer;
     int hideDelay;
     FloatingWidgetPosition preferredPosition;
     Ui::FloatingMessage *ui;
-    void doShowMessage(QString text, FloatingMessageIcon icon, int duration);
+    void doShowMessage(QString text, FloatingMessageIcon icon, int duration, QString actionText = "");
     void setIcon(FloatingMessageIcon icon);
 
 protected:
@@ -11,9 +11,9 @@ FloatingMessageProxy::~FloatingMessageProxy() {
         overlay->deleteLater();
 }
 
-void FloatingMessageProxy::showMessage(QString text, FloatingMessageIcon icon, int duration) {
+void FloatingMessageProxy::showMessage(QString text, FloatingMessageIcon icon, int duration, QString actionText) {
     init();
-    overlay->showMessage(text, icon, duration);
+    overlay->showMessage(text, icon, duration, actionText);
 }
 
 void FloatingMessageProxy::showMessage(QString text, FloatingWidgetPosition position, FloatingMessageIcon icon, int duration) {
@@ -25,5 +25,6 @@ void FloatingMessageProxy::init() {
     if(overlay)
         return;
     overlay = new FloatingMessage(container);
+    connect(overlay, &FloatingMessage::actionClicked, this, &FloatingMessageProxy::actionClicked);
 }
 
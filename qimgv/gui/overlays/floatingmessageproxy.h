@@ -2,14 +2,18 @@
 
 #include "gui/overlays/floatingmessage.h"
 
-class FloatingMessageProxy
-{
+class FloatingMessageProxy : public QObject {
+    Q_OBJECT
 public:
     FloatingMessageProxy(FloatingWidgetContainer *parent);
     ~FloatingMessageProxy();
-    void showMessage(QString text, FloatingMessageIcon icon, int duration);
+    void showMessage(QString text, FloatingMessageIcon icon, int duration, QString actionText = "");
     void showMessage(QString text, FloatingWidgetPosition position, FloatingMessageIcon icon, int duration);
     void init();
+
+signals:
+    void actionClicked();
+
 private:
     FloatingWidgetContainer *container;
     FloatingMessage *overlay;
@@ -0,0 +1,67 @@
+#include "perfoverlay.h"
+
+PerfOverlay::PerfOverlay(FloatingWidgetContainer *parent) : OverlayWidget(parent) {
+    layout.setContentsMargins(10,8,10,8);
+    layout.addWidget(&label);
+    label.setTextFormat(Qt::PlainText);
+    label.setAlignment(Qt::AlignLeft | Qt::AlignTop);
+    QFont font("monospace");
+    font.setStyleHint(QFont::TypeWriter);
+    label.setFont(font);
+    this->setLayout(&layout);
+    this->setPosition(FloatingWidgetPosition::TOPRIGHT);
+    setHorizontalMargin(0);
+    setVerticalMargin(0);
+
+    refreshTimer.setInterval(500);
+    connect(&refreshTimer, &QTimer::timeout, this, &PerfOverlay::refresh);
+
+    if(parent)
+        setContainerSize(parent->size());
+}
+
+PerfOverlay::~PerfOverlay() {
+    PerfTrace::getInstance()->setCollecting(false);
+}
+
+void PerfOverlay::show() {
+    PerfTrace::getInstance()->setCollecting(true);
+    refresh();
+    refreshTimer.start();
+    OverlayWidget::show();
+}
+
+void PerfOverlay::hide() {
+    refreshTimer.stop();
+    PerfTrace::getInstance()->setCollecting(false);
+    OverlayWidget::hide();
+}
+
+void PerfOverlay::refresh() {
+    auto trace = PerfTrace::getInstance();
+    auto timings = trace->lastTimings();
+    auto counters = trace->counters();
+    QStringList lines;
+    // ordered roughly as an image goes through them
+    static const QStringList stages = { "directory scan", "sort", "probe", "decode", "exif",
+                                        "scale", "pixmap", "display", "thumbnail" };
+    for(auto &stage : stages) {
+        QString value = timings.contains(stage) ? QString::number(timings.value(stage) / 1000.0, 'f', 1) + " ms" : "-";
+        lines << stage.leftJustified(16, ' ') + value;
+    }
+    lines << "";
+    lines << QString("image cache").leftJustified(16, ' ') + hitRate(counters, "image cache");
+    lines << QString("scaled cache").leftJustified(16, ' ') + hitRate(counters, "scaled cache");
+    lines << QString("thumbnail cache").leftJustified(16, ' ') + hitRate(counters, "thumbnail cache");
+    label.setText(lines.join("\n"));
+    adjustSize();
+    recalculateGeometry();
+}
+
+QString PerfOverlay::hitRate(const QMap<QString, qint64> &counters, QString name) {
+    qint64 hits = counters.value(name + " hit");
+    qint64 misses = counters.value(name + " miss");
+    if(hits + misses == 0)
+        return "-";
+    return QString("%1/%2 (%3%)").arg(hits).arg(hits + misses).arg(qRound(100.0 * hits / (hits + misses)));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "gui/customwidgets/overlaywidget.h"
+#include "utils/perftrace.h"
+#include <QLabel>
+#include <QTimer>
+#include <QVBoxLayout>
+
+// Shows the latest PerfTrace timings and cache statistics.
+// Collection is only enabled while this is visible.
+class PerfOverlay : public OverlayWidget {
+    Q_OBJECT
+public:
+    explicit PerfOverlay(FloatingWidgetContainer *parent = nullptr);
+    ~PerfOverlay();
+
+public slots:
+    void show();
+    void hide();
+
+private slots:
+    void refresh();
+
+private:
+    QVBoxLayout layout;
+    QLabel label;
+    QTimer refreshTimer;
+
+    QString hitRate(const QMap<QString, qint64> &counters, QString name);
+};
@@ -38,7 +38,7 @@ protected:
 
 signals:
     void itemActivated(int) override;
-    void thumbnailsRequested(QList<int>, int, bool, bool) override;
+    void thumbnailsRequested(QList<int>, int, bool, bool, int) override;
     void draggedOut() override;
     void draggedToBookmarks(QList<int>) override;
     void droppedInto(const QMimeData*, QObject*, int) override;
@@ -3,7 +3,7 @@
 ImageViewerV2::ImageViewerV2(QWidget *parent) : QGraphicsView(parent),
     pixmap(nullptr),
     pixmapScaled(nullptr),
-    movie(nullptr),
+    animation(nullptr),
     transparencyGrid(false),
     expandImage(false),
     smoothAnimatedImages(true),
@@ -48,6 +48,14 @@ ImageViewerV2::ImageViewerV2(QWidget *parent) : QGraphicsView(parent),
 
     animationTimer = new QTimer(this);
     animationTimer->setSingleShot(true);
+    animationTimer->setTimerType(Qt::PreciseTimer);
+    frameDue = 0;
+    currentFrame = 0;
+    currentFrameDelay = 0;
+    pendingFrame = -1;
+    animationPlaying = false;
+    sourceScale = 1.0;
+    fullResolutionPending = false;
 
     scaleTimer = new QTimer(this);
     scaleTimer->setSingleShot(true);
@@ -138,25 +146,27 @@ void ImageViewerV2::onFullscreenModeChanged(bool mode) {
 }
 
 void ImageViewerV2::startAnimation() {
-    if(movie && movie->frameCount() > 1) {
+    if(animation && animation->frameCount() > 1) {
         stopAnimation();
         emit animationPaused(false);
-        //movie->jumpToFrame(0);
-        //emit frameChanged(0);
-        animationTimer->start(movie->nextFrameDelay());
+        animationPlaying = true;
+        animationClock.start();
+        frameDue = 0;
+        scheduleNextFrame();
     }
 }
 
 void ImageViewerV2::stopAnimation() {
-    if(movie) {
+    if(animation) {
         emit animationPaused(true);
+        animationPlaying = false;
         animationTimer->stop();
     }
 }
 
 void ImageViewerV2::pauseResume() {
-    if(movie) {
-        if(animationTimer->isActive())
+    if(animation) {
+        if(animationPlaying)
             stopAnimation();
         else
             startAnimation();
@@ -164,95 +174,118 @@ void ImageViewerV2::pauseResume() {
 }
 
 void ImageViewerV2::onAnimationTimer() {
-    if(!movie)
+    if(!animation)
         return;
-    if(movie->currentFrameNumber() == movie->frameCount() - 1) {
+    int next = currentFrame + 1;
+    if(next >= animation->frameCount()) {
         // last frame
         if(!loopPlayback) {
+            animationPlaying = false;
             emit animationPaused(true);
             emit playbackFinished();
             return;
-        } else {
-            movie->jumpToFrame(0);
-        }
-    } else {
-        if(!movie->jumpToNextFrame()) {
-            qDebug() << "[Error] QMovie:" << movie->lastErrorString();
-            this->stopAnimation();
-            return;
         }
+        next = 0;
     }
-    emit frameChanged(movie->currentFrameNumber());
-    std::unique_ptr<QPixmap> newFrame(new QPixmap());
-    *newFrame = movie->currentPixmap();
-    updatePixmap(std::move(newFrame));
-    animationTimer->start(movie->nextFrameDelay());
+    // if the decoder fell behind we continue from onAnimationFrameReady()
+    if(showAnimationFrame(next) && pendingFrame == -1)
+        scheduleNextFrame();
+}
+
+// Deadlines come from a monotonic clock so timer jitter doesn't add up.
+// If we are late by more than a frame the schedule restarts from now
+// instead of rushing through the backlog.
+void ImageViewerV2::scheduleNextFrame() {
+    qint64 now = animationClock.elapsed();
+    frameDue += currentFrameDelay;
+    if(frameDue < now)
+        frameDue = now;
+    animationTimer->start(static_cast<int>(frameDue - now));
+}
+
+void ImageViewerV2::onAnimationFrameReady(int index) {
+    if(!animation || index != pendingFrame)
+        return;
+    AnimationFrame frame;
+    if(!animation->takeFrame(index, frame))
+        return;
+    pendingFrame = -1;
+    setAnimationFrame(frame);
+    if(animationPlaying)
+        scheduleNextFrame();
 }
 
 void ImageViewerV2::nextFrame() {
-    if(!movie) {
+    if(!animation) {
         return;
-    } else if(movie->currentFrameNumber() == movie->frameCount() - 1) {
+    } else if(currentFrame == animation->frameCount() - 1) {
         showAnimationFrame(0);
     } else {
-        showAnimationFrame(movie->currentFrameNumber() + 1);
+        showAnimationFrame(currentFrame + 1);
     }
 }
 
 void ImageViewerV2::prevFrame() {
-    if(!movie) {
+    if(!animation) {
         return;
-    } else if(movie->currentFrameNumber() == 0) {
-        showAnimationFrame(movie->frameCount() - 1);
+    } else if(currentFrame == 0) {
+        showAnimationFrame(animation->frameCount() - 1);
     } else {
-        showAnimationFrame(movie->currentFrameNumber() - 1);
+        showAnimationFrame(currentFrame - 1);
     }
 }
 
+// Never blocks. When the frame isn't decoded yet it is shown later from
+// onAnimationFrameReady(); meanwhile a paused viewer previews the nearest keyframe.
 bool ImageViewerV2::showAnimationFrame(int frame) {
-    if(!movie || frame < 0 || frame >= movie->frameCount())
+    if(!animation || frame < 0 || frame >= animation->frameCount())
         return false;
-    if(movie->currentFrameNumber() == frame)
+    if(currentFrame == frame && pendingFrame == -1)
+        return true;
+    AnimationFrame decoded;
+    if(animation->takeFrame(frame, decoded)) {
+        pendingFrame = -1;
+        setAnimationFrame(decoded);
         return true;
-    // at the first glance this may seem retarded
-    // because it is
-    // unfortunately i dont see a *better* way to do seeking with QMovie
-    // QMovie::CacheAll is buggy and memory inefficient
-    if(frame < movie->currentFrameNumber())
-        movie->jumpToFrame(0);
-    while(frame != movie->currentFrameNumber()) {
-        if(!movie->jumpToNextFrame()) {
-            qDebug() << "[Error] QMovie:" << movie->lastErrorString();
-            break;
-        }
     }
-    emit frameChanged(movie->currentFrameNumber());
-    std::unique_ptr<QPixmap> newFrame(new QPixmap());
-    *newFrame = movie->currentPixmap();
-    updatePixmap(std::move(newFrame));
+    pendingFrame = frame;
+    if(!animationPlaying && animation->nearestKeyframe(frame, decoded)) {
+        std::unique_ptr<QPixmap> preview(new QPixmap(QPixmap::fromImage(decoded.image)));
+        updatePixmap(std::move(preview));
+    }
     return true;
 }
 
+void ImageViewerV2::setAnimationFrame(const AnimationFrame &frame) {
+    currentFrame = frame.index;
+    currentFrameDelay = frame.delay;
+    emit frameChanged(currentFrame);
+    std::unique_ptr<QPixmap> newFrame(new QPixmap(QPixmap::fromImage(frame.image)));
+    updatePixmap(std::move(newFrame));
+}
+
 void ImageViewerV2::updatePixmap(std::unique_ptr<QPixmap> newPixmap) {
     pixmap = std::move(newPixmap);
+    mSourceSize = pixmap->size();
     pixmap->setDevicePixelRatio(dpr);
     pixmapItem.setPixmap(*pixmap);
     pixmapItem.show();
     pixmapItem.update();
 }
 
-void ImageViewerV2::showAnimation(std::shared_ptr<QMovie> _movie) {
-    if(_movie && _movie->isValid()) {
+void ImageViewerV2::showAnimation(std::shared_ptr<AnimationDecoder> _animation) {
+    if(_animation && _animation->isValid()) {
         reset();
-        movie = _movie;
-        movie->jumpToFrame(0);
+        animation = _animation;
+        connect(animation.get(), &AnimationDecoder::frameReady, this, &ImageViewerV2::onAnimationFrameReady);
         Qt::TransformationMode mode = smoothAnimatedImages ? Qt::SmoothTransformation : Qt::FastTransformation;
         pixmapItem.setTransformationMode(mode);
-        std::unique_ptr<QPixmap> newFrame(new QPixmap());
-        *newFrame = movie->currentPixmap();
-        updatePixmap(std::move(newFrame));
-        emit durationChanged(movie->frameCount());
-        emit frameChanged(0);
+        emit durationChanged(animation->frameCount());
+        // frame 0 is always at hand; this also starts decoding ahead
+        AnimationFrame frame;
+        if(!animation->takeFrame(0, frame))
+            frame = animation->firstFrame();
+        setAnimationFrame(frame);
 
         updateMinScale();
         if(!keepFitMode || imageFitMode == FIT_FREE)
@@ -271,13 +304,11 @@ void ImageViewerV2::showAnimation(std::shared_ptr<QMovie> _movie) {
 }
 
 // display & initialize
-void ImageViewerV2::showImage(std::unique_ptr<QPixmap> _pixmap) {
+void ImageViewerV2::showImage(std::unique_ptr<QPixmap> _pixmap, QSize _sourceSize) {
     reset();
     if(_pixmap) {
         pixmapItemScaled.hide();
-        pixmap = std::move(_pixmap);
-        pixmap->setDevicePixelRatio(dpr);
-        pixmapItem.setPixmap(*pixmap);
+        setSourcePixmap(std::move(_pixmap), _sourceSize);
         Qt::TransformationMode mode = Qt::SmoothTransformation;
         if(mScalingFilter == QI_FILTER_NEAREST)
             mode = Qt::FastTransformation;
@@ -297,10 +328,39 @@ void ImageViewerV2::showImage(std::unique_ptr<QPixmap> _pixmap) {
                 applySavedViewportPos();
         }
         requestScaling();
+        checkSourceResolution();
         update();
     }
 }
 
+// A downscaled pixmap gets a lower device pixel ratio, so the item is still laid
+// out at source size. Everything else works with sourceSize().
+void ImageViewerV2::setSourcePixmap(std::unique_ptr<QPixmap> newPixmap, QSize _sourceSize) {
+    mSourceSize = _sourceSize.isEmpty() ? newPixmap->size() : _sourceSize;
+    sourceScale = qBound(0.01, static_cast<qreal>(newPixmap->width()) / qMax(mSourceSize.width(), 1), 1.0);
+    fullResolutionPending = false;
+    pixmap = std::move(newPixmap);
+    pixmap->setDevicePixelRatio(dpr * sourceScale);
+    pixmapItem.setPixmap(*pixmap);
+}
+
+void ImageViewerV2::replaceSourcePixmap(std::unique_ptr<QPixmap> newPixmap, QSize _sourceSize) {
+    if(!pixmap || !newPixmap || animation)
+        return;
+    setSourcePixmap(std::move(newPixmap), _sourceSize);
+    // sourceSize() is the same, so there is nothing to relayout
+    requestScaling();
+    update();
+}
+
+// zoomed in past the resolution of a downscaled decode
+void ImageViewerV2::checkSourceResolution() {
+    if(sourceScale < 1.0 && !fullResolutionPending && currentScale() > sourceScale) {
+        fullResolutionPending = true;
+        emit fullResolutionRequested();
+    }
+}
+
 // reset state, remove image & stop animation
 void ImageViewerV2::reset() {
     stopPosAnimation();
@@ -310,8 +370,17 @@ void ImageViewerV2::reset() {
     pixmapItem.setScale(1.0f);
     pixmapItem.setOffset(10000,10000);
     pixmap.reset();
+    sourceScale = 1.0;
+    mSourceSize = QSize();
+    fullResolutionPending = false;
     stopAnimation();
-    movie = nullptr;
+    if(animation) {
+        disconnect(animation.get(), &AnimationDecoder::frameReady, this, &ImageViewerV2::onAnimationFrameReady);
+        animation->suspend();
+    }
+    animation = nullptr;
+    currentFrame = 0;
+    pendingFrame = -1;
     centerOn(sceneRect().center());
     // when this view is not in focus this it won't update the background
     // so we force it here
@@ -323,7 +392,7 @@ void ImageViewerV2::closeImage() {
 }
 
 void ImageViewerV2::setScaledPixmap(std::unique_ptr<QPixmap> newFrame) {
-    if(!movie && newFrame->size() != scaledSizeR() * dpr)
+    if(!animation && newFrame->size() != scaledSizeR() * dpr)
         return;
 
     pixmapScaled = std::move(newFrame);
@@ -370,7 +439,7 @@ void ImageViewerV2::setScalingFilter(ScalingFilter filter) {
 }
 
 void ImageViewerV2::setLoopPlayback(bool mode) {
-    if(movie && mode && loopPlayback != mode)
+    if(animation && mode && loopPlayback != mode)
         startAnimation();
     loopPlayback = mode;
 }
@@ -397,7 +466,7 @@ Qt::TransformationMode ImageViewerV2::selectTransformationMode() {
     Qt::TransformationMode mode = Qt::SmoothTransformation;
     if(forceFastScale) {
         mode = Qt::FastTransformation;
-    } else if(movie) {
+    } else if(animation) {
         if(!smoothAnimatedImages || (pixmapItem.scale() > 1.0f && !smoothUpscaling))
             mode = Qt::FastTransformation;
     } else {
@@ -426,7 +495,7 @@ void ImageViewerV2::hide() {
 }
 
 void ImageViewerV2::requestScaling() {
-    if(!pixmap || pixmapItem.scale() == 1.0f || (!smoothUpscaling && pixmapItem.scale() >= 1.0f) || movie)
+    if(!pixmap || pixmapItem.scale() == 1.0f || (!smoothUpscaling && pixmapItem.scale() >= 1.0f) || animation)
         return;
     if(scaleTimer->isActive())
         scaleTimer->stop();
@@ -439,8 +508,8 @@ void ImageViewerV2::requestScaling() {
 bool ImageViewerV2::imageFits() const {
     if(!pixmap)
         return true;
-    return (pixmap->width()  <= (viewport()->width()  * devicePixelRatioF()) &&
-            pixmap->height() <= (viewport()->height() * devicePixelRatioF()));
+    return (sourceSize().width()  <= (viewport()->width()  * devicePixelRatioF()) &&
+            sourceSize().height() <= (viewport()->height() * devicePixelRatioF()));
 }
 
 bool ImageViewerV2::scaledImageFits() const {
@@ -455,12 +524,44 @@ ScalingFilter ImageViewerV2::scalingFilter() const {
     return mScalingFilter;
 }
 
+// What requestScaling() would ask for if an image of this size was opened now.
+// Empty when no scaling request would be made (1:1, upscaled, other fit modes).
+QSize ImageViewerV2::fitWindowScaledSize(QSize source) const {
+    if(source.isEmpty() || mViewLock != LOCK_NONE)
+        return QSize();
+    ImageFitMode mode = imageFitModeDefault;
+    if(keepFitMode && imageFitMode != FIT_FREE)
+        mode = imageFitMode;
+    if(mode != FIT_WINDOW)
+        return QSize();
+    float scaleFitX = (float) viewport()->width()  * dpr / source.width();
+    float scaleFitY = (float) viewport()->height() * dpr / source.height();
+    float scale = qMin(scaleFitX, scaleFitY);
+    if(expandImage && scale > expandLimit)
+        scale = expandLimit;
+    bool fits = (scaleFitX >= 1.0f && scaleFitY >= 1.0f);
+    if((fits && !expandImage) || scale >= FAST_SCALE_THRESHOLD)
+        return QSize();
+    return (QSizeF(source) / dpr * scale).toSize() * dpr;
+}
+
+QSize ImageViewerV2::fitWindowTargetSize() const {
+    if(mViewLock != LOCK_NONE)
+        return QSize();
+    ImageFitMode mode = imageFitModeDefault;
+    if(keepFitMode && imageFitMode != FIT_FREE)
+        mode = imageFitMode;
+    if(mode != FIT_WINDOW)
+        return QSize();
+    return viewport()->size() * dpr;
+}
+
 QWidget *ImageViewerV2::widget() {
     return this;
 }
 
 bool ImageViewerV2::hasAnimation() const {
-    return (movie != nullptr);
+    return (animation != nullptr);
 }
 
 //  Right button zooming / dragging logic
@@ -690,8 +791,8 @@ void ImageViewerV2::mouseMoveZoom(QMouseEvent *event) {
 
 // scale at which current image fills the window
 void ImageViewerV2::updateFitWindowScale() {
-    float scaleFitX = (float) viewport()->width()  * devicePixelRatioF() / pixmap->width();
-    float scaleFitY = (float) viewport()->height() * devicePixelRatioF() / pixmap->height();
+    float scaleFitX = (float) viewport()->width()  * devicePixelRatioF() / sourceSize().width();
+    float scaleFitY = (float) viewport()->height() * devicePixelRatioF() / sourceSize().height();
     if(scaleFitX < scaleFitY) {
         fitWindowScale = scaleFitX;
     } else {
@@ -707,7 +808,7 @@ void ImageViewerV2::updateMinScale() {
     updateFitWindowScale();
     if(settings->unlockMinZoom()) {
         if(!pixmap->isNull())
-            minScale = qMax(10./pixmap->width(), 10./pixmap->height());
+            minScale = qMax(10./sourceSize().width(), 10./sourceSize().height());
         else
             minScale = 1.0f;
     } else {
@@ -723,7 +824,7 @@ void ImageViewerV2::updateMinScale() {
 void ImageViewerV2::fitWidth() {
     if(!pixmap)
         return;
-    float scaleX = (float)viewport()->width() * devicePixelRatioF() / pixmap->width();
+    float scaleX = (float)viewport()->width() * devicePixelRatioF() / sourceSize().width();
     if(!expandImage && scaleX > 1.0f)
         scaleX = 1.0f;
     if(scaleX > expandLimit)
@@ -1174,6 +1275,7 @@ void ImageViewerV2::doZoom(float newScale) {
     pixmapItem.setTransformationMode(selectTransformationMode());
     swapToOriginalPixmap();
     emit scaleChanged(newScale);
+    checkSourceResolution();
 }
 
 ImageFitMode ImageViewerV2::fitMode() const {
@@ -1216,5 +1318,5 @@ float ImageViewerV2::currentScale() const {
 QSize ImageViewerV2::sourceSize() const {
     if(!pixmap)
         return QSize(0,0);
-    return pixmap->size();
+    return mSourceSize;
 }
@@ -7,13 +7,13 @@
 #include <QWheelEvent>
 #include <QTimeLine>
 #include <QScrollBar>
-#include <QMovie>
 #include <QColor>
 #include <QTimer>
 #include <QDebug>
 #include <memory>
 #include <cmath>
 #include "settings.h"
+#include "components/animationdecoder/animationdecoder.h"
 
 enum MouseInteractionState {
     MOUSE_NONE,
@@ -40,14 +40,21 @@ public:
     virtual QRect scaledRectR() const;
     virtual float currentScale() const;
     virtual QSize sourceSize() const;
-    virtual void showImage(std::unique_ptr<QPixmap> _pixmap);
-    virtual void showAnimation(std::shared_ptr<QMovie> _animation);
+    // _sourceSize: full image size if the pixmap is a downscaled decode
+    virtual void showImage(std::unique_ptr<QPixmap> _pixmap, QSize _sourceSize = QSize());
+    virtual void showAnimation(std::shared_ptr<AnimationDecoder> _animation);
     virtual void setScaledPixmap(std::unique_ptr<QPixmap> newFrame);
+    // full resolution version of a downscaled image; keeps the view as is
+    void replaceSourcePixmap(std::unique_ptr<QPixmap> newPixmap, QSize _sourceSize = QSize());
+    // device px area that images get fit into, or empty if the current
+    // fit mode doesn't do that
+    QSize fitWindowTargetSize() const;
     virtual bool isDisplaying() const;
 
     virtual bool imageFits() const;
     bool scaledImageFits() const;
     virtual ScalingFilter scalingFilter() const;
+    QSize fitWindowScaledSize(QSize source) const;
     virtual QWidget *widget();
     bool hasAnimation() const;
 
@@ -58,6 +65,7 @@ signals:
     void scalingRequested(QSize, ScalingFilter);
     void scaleChanged(qreal);
     void sourceSizeChanged(QSize);
+    void fullResolutionRequested();
     void imageAreaChanged(QRect);
     void draggedOut();
     void playbackFinished();
@@ -112,6 +120,7 @@ protected:
 
 protected slots:
     void onAnimationTimer();
+    void onAnimationFrameReady(int index);
 
 private slots:
     void requestScaling();
@@ -124,9 +133,18 @@ private:
     QGraphicsScene *scene;
     std::shared_ptr<QPixmap> pixmap;
     std::unique_ptr<QPixmap> pixmapScaled;
-    std::shared_ptr<QMovie> movie;
+    std::shared_ptr<AnimationDecoder> animation;
     QGraphicsPixmapItem pixmapItem, pixmapItemScaled;
     QTimer *animationTimer, *scaleTimer;
+    // playback is scheduled against this clock; frameDue is when the next frame should go up (ms)
+    QElapsedTimer animationClock;
+    qint64 frameDue;
+    int currentFrame, currentFrameDelay, pendingFrame;
+    bool animationPlaying;
+    // pixmap size / source size; below 1 when the image was decoded downscaled
+    qreal sourceScale;
+    QSize mSourceSize;
+    bool fullResolutionPending;
     QScrollBar *hs, *vs;
     QPoint mouseMoveStartPos, mousePressPos, drawPos;
     bool transparencyGrid, expandImage,    smoothAnimatedImages,
@@ -179,8 +197,12 @@ private:
     QRectF sceneRoundRect(QRectF sceneRect) const;
     void doZoom(float newScale);
     void swapToOriginalPixmap();
+    void setSourcePixmap(std::unique_ptr<QPixmap> newPixmap, QSize _sourceSize);
+    void checkSourceResolution();
     void setZoomAnchor(QPoint viewportPos);
     void updatePixmap(std::unique_ptr<QPixmap> newPixmap);
+    void setAnimationFrame(const AnimationFrame &frame);
+    void scheduleNextFrame();
     Qt::TransformationMode selectTransformationMode();
     void centerIfNecessary();
     void snapToEdges();
@@ -25,6 +25,8 @@ VideoPlayerInitProxy::VideoPlayerInitProxy(QWidget *parent)
 }
 
 VideoPlayerInitProxy::~VideoPlayerInitProxy() {
+    if(libLoader)
+        libLoader->wait();
 }
 
 void VideoPlayerInitProxy::onSettingsChanged() {
@@ -32,6 +34,12 @@ void VideoPlayerInitProxy::onSettingsChanged() {
         return;
     player->setMuted(!settings->playVideoSounds());
     player->setVideoUnscaled(!settings->expandImage());
+    if(spare)
+        spare->setVideoUnscaled(!settings->expandImage());
+}
+
+void VideoPlayerInitProxy::onSpareDurationChanged(int value) {
+    spareDuration = value;
 }
 
 std::shared_ptr<VideoPlayer> VideoPlayerInitProxy::getPlayer() {
@@ -42,13 +50,13 @@ bool VideoPlayerInitProxy::isInitialized() {
     return (player != nullptr);
 }
 
-inline bool VideoPlayerInitProxy::initPlayer() {
+// sets up playerLib without loading it
+bool VideoPlayerInitProxy::findPlugin() {
 #ifndef USE_MPV
     return false;
 #endif
-    if(player)
+    if(!playerLib.fileName().isEmpty())
         return true;
-
     QFileInfo pluginFile;
     for(auto dir : libDirs) {
         pluginFile.setFile(dir + "/" + libFile);
@@ -61,40 +69,144 @@ inline bool VideoPlayerInitProxy::initPlayer() {
         qDebug() << "Could not find" << libFile << "in the following directories:" << libDirs;
         return false;
     }
+    return true;
+}
+
+// Loading the plugin pulls in libmpv and everything it links to, which is
+// the slow part. Do that on a separate thread while the ui is idle;
+// the widget itself still has to be created here.
+void VideoPlayerInitProxy::preinit() {
+    if(player || libLoader || !findPlugin())
+        return;
+    libLoader = QThread::create([this]() { playerLib.load(); });
+    connect(libLoader, &QThread::finished, this, [this]() {
+        libLoader->deleteLater();
+        libLoader = nullptr;
+        initPlayer();
+    });
+    libLoader->start(QThread::LowPriority);
+}
 
-// load lib
+std::shared_ptr<VideoPlayer> VideoPlayerInitProxy::createPlayer() {
+    std::shared_ptr<VideoPlayer> pl;
     typedef VideoPlayer* (*createPlayerWidgetFn)();
     createPlayerWidgetFn fn = (createPlayerWidgetFn) playerLib.resolve("CreatePlayerWidget");
-    if(fn) {
-        VideoPlayer* pl = fn();
-        player.reset(pl);
-    }
-    if(!player) {
+    if(fn)
+        pl.reset(fn());
+    if(!pl) {
         qDebug() << "Could not load:" << playerLib.fileName() << ". Wrong plugin version?";
-        return false;
+        return nullptr;
     }
+    pl->setMuted(!settings->playVideoSounds());
+    pl->setVideoUnscaled(!settings->expandImage());
+    pl->setVolume(settings->volume());
+    pl->setParent(this);
+    pl->hide();
+    return pl;
+}
 
-    player->setMuted(!settings->playVideoSounds());
-    player->setVideoUnscaled(!settings->expandImage());
-    player->setVolume(settings->volume());
-
-    player->setParent(this);
+inline bool VideoPlayerInitProxy::initPlayer() {
+#ifndef USE_MPV
+    return false;
+#endif
+    if(player)
+        return true;
+    if(!findPlugin())
+        return false;
+    // still loading in background
+    if(libLoader)
+        libLoader->wait();
+    player = createPlayer();
+    if(!player)
+        return false;
     layout.addWidget(player.get());
-    player->hide();
     setFocusProxy(player.get());
-    connect(player.get(), SIGNAL(durationChanged(int)), this, SIGNAL(durationChanged(int)));
-    connect(player.get(), SIGNAL(positionChanged(int)), this, SIGNAL(positionChanged(int)));
-    connect(player.get(), SIGNAL(videoPaused(bool)),    this, SIGNAL(videoPaused(bool)));
-    connect(player.get(), SIGNAL(playbackFinished()),   this, SIGNAL(playbackFinished()));
+    attach(player.get());
     return true;
 }
 
+// plugin signals have to be connected by name (it has its own copy of VideoPlayer)
+void VideoPlayerInitProxy::attach(VideoPlayer *pl) {
+    connect(pl, SIGNAL(durationChanged(int)), this, SIGNAL(durationChanged(int)));
+    connect(pl, SIGNAL(positionChanged(int)), this, SIGNAL(positionChanged(int)));
+    connect(pl, SIGNAL(videoPaused(bool)),    this, SIGNAL(videoPaused(bool)));
+    connect(pl, SIGNAL(playbackFinished()),   this, SIGNAL(playbackFinished()));
+}
+
+void VideoPlayerInitProxy::detach(VideoPlayer *pl) {
+    disconnect(pl, nullptr, this, nullptr);
+}
+
 bool VideoPlayerInitProxy::showVideo(QString file) {
     if(!initPlayer())
         return false;
+    if(spare && file == spareFile) {
+        QFileInfo fi(file);
+        if(fi.lastModified() == spareModified && fi.size() == spareSize) {
+            swapToSpare();
+            return true;
+        }
+        releasePreload();
+    }
     return player->showVideo(file);
 }
 
+// Opens the file paused & muted in the spare player, which sits right
+// under the current one. Only while a video is on screen: the gl player
+// can't open anything before it was shown once.
+void VideoPlayerInitProxy::preloadVideo(QString file) {
+    if(!player || !isVisible() || file.isEmpty() || file == spareFile)
+        return;
+    if(!spare) {
+        spare = createPlayer();
+        if(!spare)
+            return;
+    }
+    detach(spare.get());
+    connect(spare.get(), SIGNAL(durationChanged(int)), this, SLOT(onSpareDurationChanged(int)));
+    spareDuration = 0;
+    spare->setMuted(true);
+    spare->showVideo(file);
+    spare->setPaused(true);
+    spareFile = file;
+    QFileInfo fi(file);
+    spareModified = fi.lastModified();
+    spareSize = fi.size();
+    spare->setGeometry(rect());
+    spare->show();
+    spare->lower();
+}
+
+void VideoPlayerInitProxy::releasePreload() {
+    if(spare && !spareFile.isEmpty())
+        spare->stop();
+    spareFile.clear();
+    spareDuration = 0;
+}
+
+void VideoPlayerInitProxy::swapToSpare() {
+    detach(player.get());
+    detach(spare.get());
+    layout.removeWidget(player.get());
+    player.swap(spare);
+    spareFile.clear();
+    layout.addWidget(player.get());
+    player->show();
+    player->raise();
+    setFocusProxy(player.get());
+    attach(player.get());
+    // reported while it was the spare
+    emit durationChanged(spareDuration);
+    player->seek(0);
+    player->setMuted(!settings->playVideoSounds());
+    player->setVolume(settings->volume());
+    player->setPaused(false);
+    // previous one goes under and lets go of its file
+    spare->stop();
+    spare->setGeometry(rect());
+    spare->lower();
+}
+
 void VideoPlayerInitProxy::seek(int pos) {
     if(!player)
         return;
@@ -129,6 +241,7 @@ void VideoPlayerInitProxy::stop() {
     if(!player)
         return;
     player->stop();
+    releasePreload();
 }
 
 void VideoPlayerInitProxy::setPaused(bool mode) {
@@ -206,6 +319,7 @@ void VideoPlayerInitProxy::show() {
 }
 
 void VideoPlayerInitProxy::hide() {
+    releasePreload();
     if(player)
         player->hide();
     VideoPlayer::hide();
@@ -214,3 +328,9 @@ void VideoPlayerInitProxy::hide() {
 void VideoPlayerInitProxy::paintEvent(QPaintEvent *event) {
     Q_UNUSED(event)
 }
+
+void VideoPlayerInitProxy::resizeEvent(QResizeEvent *event) {
+    VideoPlayer::resizeEvent(event);
+    if(spare)
+        spare->setGeometry(rect());
+}
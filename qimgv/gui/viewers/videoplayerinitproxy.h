@@ -1,4 +1,7 @@
-// performs lazy initialization
+// Performs lazy initialization.
+// The plugin can also be loaded ahead of time in background (preinit()),
+// and a second instance can hold the next clip opened & paused, so that
+// switching to it is just a swap (preloadVideo()).
 
 #pragma once
 
@@ -10,9 +13,12 @@
 #include <QLibrary>
 #include <QLabel>
 #include <QFileInfo>
+#include <QDateTime>
+#include <QThread>
 #include <QDebug>
 
 class VideoPlayerInitProxy : public VideoPlayer {
+    Q_OBJECT
 public:
     VideoPlayerInitProxy(QWidget *parent = nullptr);
     ~VideoPlayerInitProxy();
@@ -34,6 +40,10 @@ public:
     void setLoopPlayback(bool mode);
     std::shared_ptr<VideoPlayer> getPlayer();
     bool isInitialized();
+    void preinit();
+    void preloadVideo(QString file);
+    // closes the preloaded clip, if any
+    void releasePreload();
 
 public slots:
     void show();
@@ -41,11 +51,25 @@ public slots:
 
 protected:
     void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
 
 private:
     QLibrary playerLib;
+    QThread *libLoader = nullptr;
     std::shared_ptr<VideoPlayer> player;
+    // holds the preloaded clip under the current player
+    std::shared_ptr<VideoPlayer> spare;
+    QString spareFile;
+    // to tell if spareFile was replaced since
+    QDateTime spareModified;
+    qint64 spareSize = 0;
+    int spareDuration = 0;
+    bool findPlugin();
     bool initPlayer();
+    std::shared_ptr<VideoPlayer> createPlayer();
+    void attach(VideoPlayer *pl);
+    void detach(VideoPlayer *pl);
+    void swapToSpare();
     QVBoxLayout layout;
     QLabel *errorLabel = nullptr;
 
@@ -54,8 +78,5 @@ private:
 
 private slots:
     void onSettingsChanged();
-
-signals:
-    void playbackFinished();
-
+    void onSpareDurationChanged(int value);
 };
@@ -33,6 +33,7 @@ ViewerWidget::ViewerWidget(QWidget *parent)
     imageViewer->hide();
 
     connect(imageViewer.get(), &ImageViewerV2::scalingRequested, this, &ViewerWidget::scalingRequested);
+    connect(imageViewer.get(), &ImageViewerV2::fullResolutionRequested, this, &ViewerWidget::fullResolutionRequested);
     connect(imageViewer.get(), &ImageViewerV2::scaleChanged, this, &ViewerWidget::onScaleChanged);
     connect(imageViewer.get(), &ImageViewerV2::playbackFinished, this, &ViewerWidget::onAnimationPlaybackFinished);
     connect(this, &ViewerWidget::toggleTransparencyGrid, imageViewer.get(), &ImageViewerV2::toggleTransparencyGrid);
@@ -131,6 +132,8 @@ void ViewerWidget::disableVideoPlayer() {
         disconnect(videoPlayer.get(), &VideoPlayer::positionChanged, videoControls, &VideoControlsProxyWrapper::setPlaybackPosition);
         disconnect(videoPlayer.get(), &VideoPlayer::videoPaused,     videoControls, &VideoControlsProxyWrapper::onPlaybackPaused);
         videoPlayer->setPaused(true);
+        // left video; the next clip won't be needed
+        videoPlayer->releasePreload();
         // even after calling hide() the player sends a few video frames
         // which paints over the imageviewer, causing corruption
         // so we do not HIDE it, but rather just cover it by imageviewer's widget
@@ -206,23 +209,23 @@ bool ViewerWidget::interactionEnabled() {
     return mInteractionEnabled;
 }
 
-bool ViewerWidget::showImage(std::unique_ptr<QPixmap> pixmap) {
+bool ViewerWidget::showImage(std::unique_ptr<QPixmap> pixmap, QSize sourceSize) {
     if(!pixmap)
         return false;
     stopPlayback();
     videoControls->hide();
     enableImageViewer();
-    imageViewer->showImage(std::move(pixmap));
+    imageViewer->showImage(std::move(pixmap), sourceSize);
     hideCursorTimed(false);
     return true;
 }
 
-bool ViewerWidget::showAnimation(std::shared_ptr<QMovie> movie) {
-    if(!movie)
+bool ViewerWidget::showAnimation(std::shared_ptr<AnimationDecoder> animation) {
+    if(!animation)
         return false;
     stopPlayback();
     enableImageViewer();
-    imageViewer->showAnimation(movie);
+    imageViewer->showAnimation(animation);
     hideCursorTimed(false);
     return true;
 }
@@ -235,6 +238,19 @@ bool ViewerWidget::showVideo(QString file) {
     return true;
 }
 
+void ViewerWidget::preinitVideoPlayer() {
+    videoPlayer->preinit();
+}
+
+void ViewerWidget::preloadVideo(QString file) {
+    if(currentWidget == VIDEOPLAYER)
+        videoPlayer->preloadVideo(file);
+}
+
+void ViewerWidget::releaseVideoPreload() {
+    videoPlayer->releasePreload();
+}
+
 void ViewerWidget::stopPlayback() {
     if(currentWidget == IMAGEVIEWER && imageViewer->hasAnimation())
         imageViewer->stopAnimation();
@@ -268,6 +284,11 @@ ImageFitMode ViewerWidget::fitMode() {
     return imageViewer->fitMode();
 }
 
+void ViewerWidget::replaceSourcePixmap(std::unique_ptr<QPixmap> pixmap, QSize sourceSize) {
+    if(currentWidget == IMAGEVIEWER)
+        imageViewer->replaceSourcePixmap(std::move(pixmap), sourceSize);
+}
+
 void ViewerWidget::onScalingFinished(std::unique_ptr<QPixmap> scaled) {
     imageViewer->setScaledPixmap(std::move(scaled));
 }
@@ -366,6 +387,14 @@ ScalingFilter ViewerWidget::scalingFilter() {
     return imageViewer->scalingFilter();
 }
 
+QSize ViewerWidget::fitWindowScaledSize(QSize source) {
+    return imageViewer->fitWindowScaledSize(source);
+}
+
+QSize ViewerWidget::fitWindowTargetSize() {
+    return imageViewer->fitWindowTargetSize();
+}
+
 void ViewerWidget::mousePressEvent(QMouseEvent *event) {
     hideContextMenu();
     event->ignore();
@@ -26,13 +26,16 @@ public:
     void setInteractionEnabled(bool mode);
     bool interactionEnabled();
 
-    bool showImage(std::unique_ptr<QPixmap> pixmap);
-    bool showAnimation(std::shared_ptr<QMovie> movie);
+    bool showImage(std::unique_ptr<QPixmap> pixmap, QSize sourceSize = QSize());
+    void replaceSourcePixmap(std::unique_ptr<QPixmap> pixmap, QSize sourceSize);
+    bool showAnimation(std::shared_ptr<AnimationDecoder> animation);
     void onScalingFinished(std::unique_ptr<QPixmap> scaled);
     bool isDisplaying();
     bool lockZoomEnabled();
     bool lockViewEnabled();
     ScalingFilter scalingFilter();
+    QSize fitWindowScaledSize(QSize source);
+    QSize fitWindowTargetSize();
 
 private:
     QVBoxLayout layout;
@@ -63,6 +66,7 @@ private slots:
 
 signals:
     void scalingRequested(QSize, ScalingFilter);
+    void fullResolutionRequested();
     void zoomIn();
     void zoomOut();
     void zoomInCursor();
@@ -86,6 +90,9 @@ signals:
 
 public slots:
     bool showVideo(QString file);
+    void preinitVideoPlayer();
+    void preloadVideo(QString file);
+    void releaseVideoPreload();
     void stopPlayback();
     void setFitMode(ImageFitMode mode);
     ImageFitMode fitMode();
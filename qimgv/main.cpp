@@ -9,6 +9,7 @@
 #include "utils/inputmap.h"
 #include "utils/actions.h"
 #include "utils/cmdoptionsrunner.h"
+#include "utils/perftrace.h"
 #include "sharedresources.h"
 #include "proxystyle.h"
 #include "core.h"
@@ -108,6 +109,10 @@ int main(int argc, char *argv[]) {
     qRegisterMetaType<Script>("Script");
     qRegisterMetaType<std::shared_ptr<Image>>("std::shared_ptr<Image>");
     qRegisterMetaType<std::shared_ptr<Thumbnail>>("std::shared_ptr<Thumbnail>");
+    qRegisterMetaType<std::shared_ptr<ListingSnapshot>>("std::shared_ptr<ListingSnapshot>");
+    qRegisterMetaType<QVector<MetadataResult>>("QVector<MetadataResult>");
+    qRegisterMetaType<FileOpTask>("FileOpTask");
+    qRegisterMetaType<QMap<QString, QString>>("QMap<QString,QString>");
 #if QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
     qRegisterMetaTypeStreamOperators<Script>("Script");
 #endif
@@ -140,9 +145,15 @@ int main(int argc, char *argv[]) {
             QCoreApplication::translate("main", "thumbnail-size")},
         {"build-options",
             QCoreApplication::translate("main", "Show build options.")},
+        {"trace",
+            QCoreApplication::translate("main", "Record timings and write them to a Chrome trace (JSON) file on exit."),
+            QCoreApplication::translate("main", "trace-file")},
     });
     parser.process(a);
 
+    if(parser.isSet("trace"))
+        PerfTrace::getInstance()->setTraceFile(parser.value("trace"));
+
     if(parser.isSet("build-options")) {
         CmdOptionsRunner r;
         QTimer::singleShot(0, &r, &CmdOptionsRunner::showBuildOptions);
@@ -176,5 +187,7 @@ int main(int argc, char *argv[]) {
     qApp->processEvents();
 
     core.showGui();
-    return a.exec();
+    int ret = a.exec();
+    PerfTrace::getInstance()->writeTrace();
+    return ret;
 }
@@ -56,11 +56,15 @@ void Settings::setupCache() {
     }
     mThumbCacheDir = new QDir(mTmpDir->absolutePath() + "/thumbnails");
     mThumbCacheDir->mkpath(mThumbCacheDir->absolutePath());
+    mListingCacheDir = new QDir(mTmpDir->absolutePath() + "/listings");
+    mListingCacheDir->mkpath(mListingCacheDir->absolutePath());
 #else
     mTmpDir = new QDir(QApplication::applicationDirPath() + "/cache");
     mTmpDir->mkpath(mTmpDir->absolutePath());
     mThumbCacheDir = new QDir(QApplication::applicationDirPath() + "/thumbnails");
     mThumbCacheDir->mkpath(mThumbCacheDir->absolutePath());
+    mListingCacheDir = new QDir(mTmpDir->absolutePath() + "/listings");
+    mListingCacheDir->mkpath(mListingCacheDir->absolutePath());
 #endif
 }
 //------------------------------------------------------------------------------
@@ -73,6 +77,10 @@ QString Settings::thumbnailCacheDir() {
     return mThumbCacheDir->path() + "/";
 }
 //------------------------------------------------------------------------------
+QString Settings::listingCacheDir() {
+    return mListingCacheDir->path() + "/";
+}
+//------------------------------------------------------------------------------
 QString Settings::tmpDir() {
     return mTmpDir->path() + "/";
 }
@@ -423,14 +431,14 @@ void Settings::setBlurBackground(bool mode) {
 }
 //------------------------------------------------------------------------------
 void Settings::setSortingMode(SortingMode mode) {
-    if(mode >= 6)
+    if(mode > SortingMode::SORT_TYPE)
         mode = SortingMode::SORT_NAME;
     settings->settingsConf->setValue("sortingMode", mode);
 }
 
 SortingMode Settings::sortingMode() {
     int mode = settings->settingsConf->value("sortingMode", 0).toInt();
-    if(mode < 0 || mode >= 6)
+    if(mode < 0 || mode > SortingMode::SORT_TYPE)
         mode = 0;
     return static_cast<SortingMode>(mode);
 }
@@ -725,6 +733,20 @@ void Settings::setUseThumbnailCache(bool mode) {
     settings->settingsConf->setValue("thumbnailCache", mode);
 }
 //------------------------------------------------------------------------------
+// ~/.cache/thumbnails, used by most linux file managers
+bool Settings::sharedThumbnailCache() {
+#ifdef __linux__
+    bool defaultValue = true;
+#else
+    bool defaultValue = false;
+#endif
+    return settings->settingsConf->value("sharedThumbnailCache", defaultValue).toBool();
+}
+
+void Settings::setSharedThumbnailCache(bool mode) {
+    settings->settingsConf->setValue("sharedThumbnailCache", mode);
+}
+//------------------------------------------------------------------------------
 QStringList Settings::savedPaths() {
     return settings->stateConf->value("savedPaths", QDir::homePath()).toStringList();
 }
@@ -1155,3 +1177,62 @@ bool Settings::trackpadDetection() {
 void Settings::setTrackpadDetection(bool mode) {
     settings->settingsConf->setValue("trackpadDetection", mode);
 }
+//------------------------------------------------------------------------------
+bool Settings::decodeAtDisplaySize() {
+    return settings->settingsConf->value("decodeAtDisplaySize", true).toBool();
+}
+
+void Settings::setDecodeAtDisplaySize(bool mode) {
+    settings->settingsConf->setValue("decodeAtDisplaySize", mode);
+}
+//------------------------------------------------------------------------------
+bool Settings::listingSnapshots() {
+    return settings->settingsConf->value("listingSnapshots", true).toBool();
+}
+
+void Settings::setListingSnapshots(bool mode) {
+    settings->settingsConf->setValue("listingSnapshots", mode);
+}
+//------------------------------------------------------------------------------
+// -1 == unlimited
+int Settings::recursiveScanDepth() {
+    return settings->settingsConf->value("recursiveScanDepth", -1).toInt();
+}
+
+void Settings::setRecursiveScanDepth(int depth) {
+    settings->settingsConf->setValue("recursiveScanDepth", depth);
+}
+//------------------------------------------------------------------------------
+QStringList Settings::recursiveScanExcludes() {
+    return settings->settingsConf->value("recursiveScanExcludes", QStringList()).toStringList();
+}
+
+void Settings::setRecursiveScanExcludes(QStringList patterns) {
+    settings->settingsConf->setValue("recursiveScanExcludes", patterns);
+}
+//------------------------------------------------------------------------------
+bool Settings::recursiveScanFollowSymlinks() {
+    return settings->settingsConf->value("recursiveScanFollowSymlinks", false).toBool();
+}
+
+void Settings::setRecursiveScanFollowSymlinks(bool mode) {
+    settings->settingsConf->setValue("recursiveScanFollowSymlinks", mode);
+}
+//------------------------------------------------------------------------------
+// smaller images are left out of the file list; 0 == any
+QSize Settings::filterMinResolution() {
+    return settings->settingsConf->value("filterMinResolution", QSize(0, 0)).toSize();
+}
+
+void Settings::setFilterMinResolution(QSize size) {
+    settings->settingsConf->setValue("filterMinResolution", size);
+}
+//------------------------------------------------------------------------------
+// bitmask of (1 << DocumentType); -1 == all
+int Settings::filterDocumentTypes() {
+    return settings->settingsConf->value("filterDocumentTypes", -1).toInt();
+}
+
+void Settings::setFilterDocumentTypes(int types) {
+    settings->settingsConf->setValue("filterDocumentTypes", types);
+}
@@ -25,7 +25,13 @@ enum SortingMode {
     SORT_SIZE,
     SORT_SIZE_DESC,
     SORT_TIME,
-    SORT_TIME_DESC
+    SORT_TIME_DESC,
+    // from the metadata index
+    SORT_CAPTURE_TIME,
+    SORT_CAPTURE_TIME_DESC,
+    SORT_RESOLUTION,
+    SORT_RESOLUTION_DESC,
+    SORT_TYPE
 };
 
 enum ImageFitMode {
@@ -120,6 +126,7 @@ public:
     void setVolume(int vol);
     int volume();
     QString thumbnailCacheDir();
+    QString listingCacheDir();
     QString mpvBinary();
     void setMpvBinary(QString path);
     PanelPosition panelPosition();
@@ -140,6 +147,8 @@ public:
     void setEnableSmoothScroll(bool mode);
     bool useThumbnailCache();
     void setUseThumbnailCache(bool mode);
+    bool sharedThumbnailCache();
+    void setSharedThumbnailCache(bool mode);
     QStringList savedPaths();
     void setSavedPaths(QStringList paths);
     QString tmpDir();
@@ -297,11 +306,25 @@ public:
     void setSortFolders(bool mode);
     bool trackpadDetection();
     void setTrackpadDetection(bool mode);
+    bool decodeAtDisplaySize();
+    void setDecodeAtDisplaySize(bool mode);
+    bool listingSnapshots();
+    void setListingSnapshots(bool mode);
+    int recursiveScanDepth();
+    void setRecursiveScanDepth(int depth);
+    QStringList recursiveScanExcludes();
+    void setRecursiveScanExcludes(QStringList patterns);
+    bool recursiveScanFollowSymlinks();
+    void setRecursiveScanFollowSymlinks(bool mode);
+    QSize filterMinResolution();
+    void setFilterMinResolution(QSize size);
+    int filterDocumentTypes();
+    void setFilterDocumentTypes(int types);
 
 private:
     explicit Settings(QObject *parent = nullptr);
     QSettings *settingsConf, *stateConf, *themeConf;
-    QDir *mTmpDir, *mThumbCacheDir, *mConfDir;
+    QDir *mTmpDir, *mThumbCacheDir, *mListingCacheDir, *mConfDir;
     ColorScheme mColorScheme;
     QMultiMap<QByteArray, QByteArray> mVideoFormatsMap; // [mimetype, format]
     void loadTheme();
@@ -11,7 +11,9 @@ DocumentInfo::DocumentInfo(QString path)
         qDebug() << "FileInfo: cannot open: " << path;
         return;
     }
-    detectFormat();
+    // only for the probes below; decoders map the file again for themselves
+    MappedFile file(path);
+    detectFormat(file);
 }
 
 DocumentInfo::~DocumentInfo() {
@@ -68,21 +70,26 @@ int DocumentInfo::exifOrientation() const {
     return mOrientation;
 }
 
+std::shared_ptr<MappedFile> DocumentInfo::fileData() const {
+    return std::make_shared<MappedFile>(filePath());
+}
+
 // ##############################################################
 // ####################### PRIVATE METHODS ######################
 // ##############################################################
-void DocumentInfo::detectFormat() {
+void DocumentInfo::detectFormat(const MappedFile &file) {
     if(mDocumentType != DocumentType::NONE)
         return;
     QMimeDatabase mimeDb;
-    mMimeType = mimeDb.mimeTypeForFile(fileInfo.filePath(), QMimeDatabase::MatchContent);
+    // same amount QMimeDatabase would read from the file itself
+    mMimeType = mimeDb.mimeTypeForData(file.head(16 * 1024));
     auto mimeName = mMimeType.name().toUtf8();
     auto suffix = fileInfo.suffix().toLower().toUtf8();
     if(mimeName == "image/jpeg") {
         mFormat = "jpg";
         mDocumentType = DocumentType::STATIC;
     } else if(mimeName == "image/png") {
-        if(QImageReader::supportedImageFormats().contains("apng") && detectAPNG()) {
+        if(QImageReader::supportedImageFormats().contains("apng") && detectAPNG(file)) {
             mFormat = "apng";
             mDocumentType = DocumentType::ANIMATED;
         } else {
@@ -94,17 +101,17 @@ void DocumentInfo::detectFormat() {
         mDocumentType = DocumentType::ANIMATED;
     } else if(mimeName == "image/webp" || (mimeName == "audio/x-riff" && suffix == "webp")) {
         mFormat = "webp";
-        mDocumentType = detectAnimatedWebP() ? DocumentType::ANIMATED : DocumentType::STATIC;
+        mDocumentType = detectAnimatedWebP(file) ? DocumentType::ANIMATED : DocumentType::STATIC;
     } else if(mimeName == "image/jxl") {
         mFormat = "jxl";
-        mDocumentType = detectAnimatedJxl() ? DocumentType::ANIMATED : DocumentType::STATIC;
+        mDocumentType = detectAnimatedJxl(file) ? DocumentType::ANIMATED : DocumentType::STATIC;
         if(mDocumentType == DocumentType::ANIMATED && !settings->jxlAnimation()) {
             mDocumentType = DocumentType::NONE;
             qDebug() << "animated jxl is off; skipping file";
         }
     } else if(mimeName == "image/avif") {
         mFormat = "avif";
-        mDocumentType = detectAnimatedAvif() ? DocumentType::ANIMATED : DocumentType::STATIC;
+        mDocumentType = detectAnimatedAvif(file) ? DocumentType::ANIMATED : DocumentType::STATIC;
     } else if(mimeName == "image/bmp") {
         mFormat = "bmp";
         mDocumentType = DocumentType::STATIC;
@@ -121,85 +128,76 @@ void DocumentInfo::detectFormat() {
         else
             mDocumentType = DocumentType::STATIC;
     }
-    loadExifOrientation();
+    loadExifOrientation(file);
 }
 
 inline
 // dumb apng detector
-bool DocumentInfo::detectAPNG() {
-    QFile f(fileInfo.filePath());
-    if(f.open(QFile::ReadOnly)) {
-        QDataStream in(&f);
-        const int len = 120;
-        QByteArray qbuf("\0", len);
-        if (in.readRawData(qbuf.data(), len) > 0) {
-            return qbuf.contains("acTL");
-        }
-    }
-    return false;
+bool DocumentInfo::detectAPNG(const MappedFile &file) {
+    return file.head(120).contains("acTL");
 }
 
-bool DocumentInfo::detectAnimatedWebP() {
-    QFile f(fileInfo.filePath());
-    bool result = false;
-    if(f.open(QFile::ReadOnly)) {
-        QDataStream in(&f);
-        in.skipRawData(12);
-        char *buf = static_cast<char*>(malloc(5));
-        buf[4] = '\0';
-        in.readRawData(buf, 4);
-        if(strcmp(buf, "VP8X") == 0) {
-            in.skipRawData(4);
-            char flags;
-            in.readRawData(&flags, 1);
-            if(flags & (1 << 1)) {
-                result = true;
-            }
-        }
-        free(buf);
-    }
-    return result;
+bool DocumentInfo::detectAnimatedWebP(const MappedFile &file) {
+    QByteArray head = file.head(21);
+    if(head.size() < 21 || head.mid(12, 4) != "VP8X")
+        return false;
+    char flags = head.at(20);
+    return (flags & (1 << 1));
 }
 
 // TODO avoid creating multiple QImageReader instances
-bool DocumentInfo::detectAnimatedJxl() {
-    QImageReader r(fileInfo.filePath(), "jxl");
+bool DocumentInfo::detectAnimatedJxl(const MappedFile &file) {
+    auto device = file.device();
+    QImageReader r(device.get(), "jxl");
     return r.supportsAnimation();
 }
 
-bool DocumentInfo::detectAnimatedAvif() {
-    QFile f(fileInfo.filePath());
-    bool result = false;
-    if(f.open(QFile::ReadOnly)) {
-        QDataStream in(&f);
-        in.skipRawData(4); // skip box size
-        char *buf = static_cast<char*>(malloc(9));
-        buf[8] = '\0';
-        in.readRawData(buf, 8);
-        if(strcmp(buf, "ftypavis") == 0) {
-            result = true;
-        }
-        free(buf);
-    }
-    return result;
+bool DocumentInfo::detectAnimatedAvif(const MappedFile &file) {
+    // skip box size
+    return file.head(12).mid(4, 8) == "ftypavis";
 }
 
 void DocumentInfo::loadExifTags() {
     if(exifLoaded)
         return;
+    if(mDocumentType != DocumentType::VIDEO && mDocumentType != DocumentType::NONE)
+        exifTags = readExifTags(*fileData());
+    exifLoaded = true;
+}
+
+void DocumentInfo::setExifTags(QMap<QString, QString> tags) {
+    exifTags = tags;
     exifLoaded = true;
-    exifTags.clear();
+}
+
+bool DocumentInfo::exifTagsLoaded() const {
+    return exifLoaded;
+}
+
+// Does not touch any members so it can run on any thread.
+QMap<QString, QString> DocumentInfo::readExifTags(const QString &path) {
+    MappedFile file(path);
+    return readExifTags(file);
+}
+
+QMap<QString, QString> DocumentInfo::readExifTags(const MappedFile &file) {
+    PerfScope scope("exif", file.path());
+    QMap<QString, QString> exifTags;
 #ifdef USE_EXIV2
     try {
         std::unique_ptr<Exiv2::Image> image;
 
-        image = Exiv2::ImageFactory::open(toStdString(fileInfo.filePath()));
+        // exiv2 reads from memory without copying
+        if(file.isMapped())
+            image = Exiv2::ImageFactory::open(file.data(), file.size());
+        else
+            image = Exiv2::ImageFactory::open(toStdString(file.path()));
 
         assert(image.get() != 0);
         image->readMetadata();
         Exiv2::ExifData &exifData = image->exifData();
         if(exifData.empty())
-            return;
+            return exifTags;
 
         Exiv2::ExifKey make("Exif.Image.Make");
         Exiv2::ExifKey model("Exif.Image.Model");
@@ -271,9 +269,10 @@ void DocumentInfo::loadExifTags() {
     // No exception was caught, which may cause QT crash
     catch (Exiv2::Error& e) {
         qDebug() << "Caught Exiv2 exception:\n" << e.what() << "\n";
-        return;
+        return exifTags;
     }
 #endif
+    return exifTags;
 }
 
 QMap<QString, QString> DocumentInfo::getExifTags() {
@@ -282,18 +281,12 @@ QMap<QString, QString> DocumentInfo::getExifTags() {
     return exifTags;
 }
 
-void DocumentInfo::loadExifOrientation() {
+void DocumentInfo::loadExifOrientation(const MappedFile &file) {
     if(mDocumentType == DocumentType::VIDEO || mDocumentType == DocumentType::NONE)
         return;
 
-    QString path = filePath();
-    QImageReader *reader = nullptr;
-    if(!mFormat.isEmpty())
-        reader = new QImageReader(path, mFormat.toStdString().c_str());
-    else
-        reader = new QImageReader(path);
-
-    if(reader->canRead())
-        mOrientation = static_cast<int>(reader->transformation());
-    delete reader;
+    auto device = file.device();
+    QImageReader reader(device.get(), mFormat.toStdString().c_str());
+    if(reader.canRead())
+        mOrientation = static_cast<int>(reader.transformation());
 }
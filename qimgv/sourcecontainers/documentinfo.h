@@ -10,6 +10,8 @@
 #include <cmath>
 #include <cstring>
 #include "utils/stuff.h"
+#include "utils/perftrace.h"
+#include "utils/mappedfile.h"
 #include "settings.h"
 
 #ifdef USE_EXIV2
@@ -45,7 +47,15 @@ public:
     QDateTime lastModified() const;
     void refresh();
     void loadExifTags();
+    void setExifTags(QMap<QString, QString> tags);
+    bool exifTagsLoaded() const;
     QMap<QString, QString> getExifTags();
+    static QMap<QString, QString> readExifTags(const QString &path);
+    static QMap<QString, QString> readExifTags(const MappedFile &file);
+
+    // Contents of the file, mapped anew on every call.
+    // Hold it for one decode / probe only, then let it go.
+    std::shared_ptr<MappedFile> fileData() const;
 
 private:
     QFileInfo fileInfo;
@@ -56,12 +66,12 @@ private:
 
     // guesses file type from its contents
     // and sets extension
-    void detectFormat();
-    void loadExifOrientation();
-    bool detectAPNG();
-    bool detectAnimatedWebP();
-    bool detectAnimatedJxl();
-    bool detectAnimatedAvif();
+    void detectFormat(const MappedFile &file);
+    void loadExifOrientation(const MappedFile &file);
+    bool detectAPNG(const MappedFile &file);
+    bool detectAnimatedWebP(const MappedFile &file);
+    bool detectAnimatedJxl(const MappedFile &file);
+    bool detectAnimatedAvif(const MappedFile &file);
     QMap<QString, QString> exifTags;
     QMimeType mMimeType;
 };
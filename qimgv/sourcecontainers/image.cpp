@@ -19,6 +19,14 @@ Image::Image(std::unique_ptr<DocumentInfo> _info)
 Image::~Image() {
 }
 
+std::shared_ptr<const QImage> Image::getDisplayImage() {
+    return getImage();
+}
+
+bool Image::isDownscaled() {
+    return false;
+}
+
 QString Image::filePath() const {
     return mPath;
 }
@@ -47,6 +55,10 @@ qint64 Image::fileSize() const {
     return mDocInfo->fileSize();
 }
 
+void Image::refreshFileInfo() {
+    mDocInfo->refresh();
+}
+
 QDateTime Image::lastModified() const {
     return mDocInfo->lastModified();
 }
@@ -55,3 +67,15 @@ QMap<QString, QString> Image::getExifTags() {
     return mDocInfo->getExifTags();
 }
 
+void Image::loadExifTags() {
+    mDocInfo->loadExifTags();
+}
+
+void Image::setExifTags(QMap<QString, QString> tags) {
+    mDocInfo->setExifTags(tags);
+}
+
+bool Image::exifTagsLoaded() const {
+    return mDocInfo->exifTagsLoaded();
+}
+
@@ -15,6 +15,10 @@ public:
     virtual ~Image() = 0;
     virtual std::unique_ptr<QPixmap> getPixmap() = 0;
     virtual std::shared_ptr<const QImage> getImage() = 0;
+    // what's on screen; may be smaller than size() (see isDownscaled())
+    virtual std::shared_ptr<const QImage> getDisplayImage();
+    // decoded below full resolution; getImage() decodes the rest on demand
+    virtual bool isDownscaled();
     DocumentType type() const;
     QString filePath() const;
     virtual int height() = 0;
@@ -27,8 +31,13 @@ public:
     QString baseName() const;
     bool isEdited() const;
     qint64 fileSize() const;
+    // the file was rewritten by someone else (see Saver)
+    void refreshFileInfo();
     QDateTime lastModified() const;
     QMap<QString, QString> getExifTags();
+    void loadExifTags();
+    void setExifTags(QMap<QString, QString> tags);
+    bool exifTagsLoaded() const;
 
 protected:
     virtual void load() = 0;
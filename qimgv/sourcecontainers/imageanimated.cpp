@@ -25,23 +25,25 @@ ImageAnimated::~ImageAnimated() {
 void ImageAnimated::load() {
     if(isLoaded())
         return;
-    loadMovie();
+    loadAnimation();
     mLoaded = true;
 }
 
-void ImageAnimated::loadMovie() {
-    movie.reset(new QMovie());
-    movie->setFileName(mPath);
-    movie->setFormat(mDocInfo->format().toStdString().c_str());
-    movie->jumpToFrame(0);
-    mSize = movie->frameRect().size();
-    mFrameCount = movie->frameCount();
+void ImageAnimated::loadAnimation() {
+    animation.reset(new AnimationDecoder(mPath, mDocInfo->format().toLatin1()));
+    mSize = animation->size();
+    mFrameCount = animation->frameCount();
 }
 
 int ImageAnimated::frameCount() {
     return mFrameCount;
 }
 
+// ms, -1 if not known yet
+int ImageAnimated::duration() {
+    return getAnimation()->duration();
+}
+
 // TODO: overwrite (self included)
 bool ImageAnimated::save(QString destPath) {
     QFile file(mPath);
@@ -67,20 +69,21 @@ bool ImageAnimated::save() {
     return false;
 }
 
-// in case of gif returns current frame
+// returns the frame currently on screen (first frame if not playing)
+// both share pixel data with the decoder, nothing is read from disk
 std::unique_ptr<QPixmap> ImageAnimated::getPixmap() {
-    return std::unique_ptr<QPixmap>(new QPixmap(mPath, mDocInfo->format().toStdString().c_str()));
+    return std::unique_ptr<QPixmap>(new QPixmap(QPixmap::fromImage(getAnimation()->currentFrame().image)));
 }
 
 std::shared_ptr<const QImage> ImageAnimated::getImage() {
-    std::shared_ptr<const QImage> img(new QImage(mPath, mDocInfo->format().toStdString().c_str()));
+    std::shared_ptr<const QImage> img(new QImage(getAnimation()->currentFrame().image));
     return img;
 }
 
-std::shared_ptr<QMovie> ImageAnimated::getMovie() {
-    if(movie == nullptr)
-        loadMovie();
-    return movie;
+std::shared_ptr<AnimationDecoder> ImageAnimated::getAnimation() {
+    if(animation == nullptr)
+        loadAnimation();
+    return animation;
 }
 
 int ImageAnimated::height() {
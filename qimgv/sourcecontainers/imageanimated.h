@@ -1,8 +1,8 @@
 #pragma once
 
 #include "image.h"
-#include <QMovie>
 #include <QTimer>
+#include "components/animationdecoder/animationdecoder.h"
 
 class ImageAnimated : public Image {
 public:
@@ -12,7 +12,7 @@ public:
 
     std::unique_ptr<QPixmap> getPixmap();
     std::shared_ptr<const QImage> getImage();
-    std::shared_ptr<QMovie> getMovie();
+    std::shared_ptr<AnimationDecoder> getAnimation();
     int height();
     int width();
     QSize size();
@@ -21,6 +21,7 @@ public:
     bool isEdited();
 
     int frameCount();
+    int duration();
 public slots:
     bool save();
     bool save(QString destPath);
@@ -32,6 +33,6 @@ private:
     void load();
     QSize mSize;
     int mFrameCount;
-    std::shared_ptr<QMovie> movie;
-    void loadMovie();
+    std::shared_ptr<AnimationDecoder> animation;
+    void loadAnimation();
 };
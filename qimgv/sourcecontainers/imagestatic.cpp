@@ -13,6 +13,13 @@ ImageStatic::ImageStatic(std::unique_ptr<DocumentInfo> _info)
     load();
 }
 
+ImageStatic::ImageStatic(std::unique_ptr<DocumentInfo> _info, QSize _displaySize)
+    : Image(std::move(_info)),
+      displaySize(_displaySize)
+{
+    load();
+}
+
 ImageStatic::~ImageStatic() {
 }
 
@@ -23,12 +30,36 @@ void ImageStatic::load() {
     }
     if(mDocInfo->mimeType().name() == "image/vnd.microsoft.icon")
         loadICO();
+    else if(mDocInfo->format() == "jpg")
+        loadGeneric(displaySize);
     else
-        loadGeneric();
+        loadGeneric(QSize());
+}
+
+
+// Largest 1/2, 1/4 or 1/8 of source that still covers the target after fitting.
+// libjpeg does these during the DCT, so it's much cheaper than a full decode.
+QSize ImageStatic::reducedDecodeSize(QSize source, QSize target) const {
+    if(!source.isValid() || !target.isValid())
+        return QSize();
+    // target is in display orientation
+    if(mDocInfo->exifOrientation() >= 4)
+        target.transpose();
+    if(source.width() <= target.width() && source.height() <= target.height())
+        return QSize();
+    QSize fitted = source.scaled(target, Qt::KeepAspectRatio);
+    for(int denom = 8; denom > 1; denom /= 2) {
+        QSize reduced((source.width() + denom - 1) / denom, (source.height() + denom - 1) / denom);
+        if(reduced.width() >= fitted.width() && reduced.height() >= fitted.height())
+            return reduced;
+    }
+    return QSize();
 }
 
-
-void ImageStatic::loadGeneric() {
+// targetSize: decode at reduced resolution if possible; full if invalid.
+// sourceSize gets the full size in display orientation, reduced tells which one came out.
+// Doesn't touch the image members, so it runs without holding the mutex.
+std::unique_ptr<const QImage> ImageStatic::decode(QSize targetSize, QSize &sourceSize, bool &reduced) {
     /* QImageReader::read() seems more reliable than just reading via QImage.
      * For example: "Invalid JPEG file structure: two SOF markers"
      * QImageReader::read() returns false, but still reads an image. Meanwhile QImage just fails.
@@ -37,10 +68,17 @@ void ImageStatic::loadGeneric() {
      *
      * tldr: qimage bad
      */
-    QImageReader r(mPath, mDocInfo->format().toStdString().c_str());
+    auto file = mDocInfo->fileData();
+    file->willNeed();
+    auto device = file->device();
+    QImageReader r(device.get(), mDocInfo->format().toStdString().c_str());
 #if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
     r.setAllocationLimit(settings->memoryAllocationLimit());
 #endif
+    sourceSize = r.size();
+    QSize reducedSize = reducedDecodeSize(sourceSize, targetSize);
+    if(reducedSize.isValid())
+        r.setScaledSize(reducedSize);
     QImage *tmp = new QImage();
     r.read(tmp);
     std::unique_ptr<const QImage> img(tmp);
@@ -50,14 +88,61 @@ void ImageStatic::loadGeneric() {
     if(img->format() == QImage::Format_Mono) {
         QImage *imgConverted = new QImage();
         *imgConverted = img->convertToFormat(QImage::Format_Grayscale8);
-        image.reset(imgConverted);
+        img.reset(imgConverted);
+    }
+    reduced = reducedSize.isValid() && !img->isNull();
+    if(mDocInfo->exifOrientation() >= 4)
+        sourceSize.transpose();
+    return img;
+}
+
+// only from load(); nobody else has the object yet
+void ImageStatic::loadGeneric(QSize targetSize) {
+    QSize sourceSize;
+    bool reduced;
+    auto img = decode(targetSize, sourceSize, reduced);
+    if(reduced) {
+        imageReduced = std::move(img);
+        fullSize = sourceSize;
     } else {
-        // set image
         image = std::move(img);
+        imageReduced.reset();
+        fullSize = image->size();
     }
     mLoaded = true;
 }
 
+// The decode itself runs unlocked, so getDisplayImage() & co. don't wait for it.
+std::shared_ptr<const QImage> ImageStatic::fullImage() {
+    {
+        QMutexLocker lock(&mutex);
+        if(image)
+            return image;
+    }
+    // one full decode at a time; whoever waited here gets its result
+    QMutexLocker decodeLock(&decodeMutex);
+    {
+        QMutexLocker lock(&mutex);
+        if(image)
+            return image;
+    }
+    std::shared_ptr<const QImage> decoded;
+    {
+        PerfScope scope("decode full", mPath);
+        QSize sourceSize;
+        bool reduced;
+        decoded = decode(QSize(), sourceSize, reduced);
+    }
+    QMutexLocker lock(&mutex);
+    // commitEdits() may have put an edited image in meanwhile
+    if(!image) {
+        image = decoded;
+        imageReduced.reset();
+        fullSize = image->size();
+    }
+    return image;
+}
+
 // TODO: move this out somewhere to use in other places
 void ImageStatic::loadICO() {
     // Big brain code. It's mostly for small ico files so whatever. I'm not patching Qt for this.
@@ -70,61 +155,31 @@ void ImageStatic::loadICO() {
     QPixmap iconPix = icon.pixmap(maxSize);
     std::unique_ptr<const QImage> img(new QImage(iconPix.toImage()));
     image = std::move(img);
+    fullSize = image->size();
     mLoaded = true;
 }
 
-QString ImageStatic::generateHash(QString str) {
-    return QString(QCryptographicHash::hash(str.toUtf8(), QCryptographicHash::Md5).toHex());
-}
-
-// TODO: move saving to directorymodel
+// Makes the edited image the current one, and returns what should be written.
+// The result is never changed afterwards, so it can be encoded on any thread.
+// An unedited image shown at reduced size is fully decoded here; check
+// isDownscaled() first where that matters.
+std::shared_ptr<const QImage> ImageStatic::commitEdits() {
+    if(!isEdited())
+        return getSourceImage();
+    QMutexLocker lock(&mutex);
+    image.swap(imageEdited);
+    imageReduced.reset();
+    fullSize = image->size();
+    std::shared_ptr<const QImage> result = image;
+    lock.unlock();
+    discardEditedImage();
+    return result;
+}
+
+// encoded into a temporary file first; original stays intact on failure
 bool ImageStatic::save(QString destPath) {
-    QString tmpPath = destPath + "_" + generateHash(destPath);
-    QFileInfo fi(destPath);
-    QString ext = fi.suffix();
-    // png compression note from libpng
-    // Note that tests have shown that zlib compression levels 3-6 usually perform as well
-    // as level 9 for PNG images, and do considerably fewer caclulations
-    int quality = 95;
-    if(ext.compare("png", Qt::CaseInsensitive) == 0)
-        quality = 30;
-    else if(ext.compare("jpg", Qt::CaseInsensitive) == 0 || ext.compare("jpeg", Qt::CaseInsensitive) == 0)
-        quality = settings->JPEGSaveQuality();
-
-    bool backupExists = false, success = false, originalExists = false;
-
-    if(QFile::exists(destPath))
-        originalExists = true;
-
-    // backup the original file if possible
-    if(originalExists) {
-        QFile::remove(tmpPath);
-        if(!QFile::copy(destPath, tmpPath)) {
-            qDebug() << "ImageStatic::save() - Could not create file backup.";
-            return false;
-        }
-        backupExists = true;
-    }
-    // save file
-    if(isEdited()) {
-        success = imageEdited->save(destPath, ext.toStdString().c_str(), quality);
-        image.swap(imageEdited);
-        discardEditedImage();
-    } else {
-        success = image->save(destPath, ext.toStdString().c_str(), quality);
-    }
-    if(backupExists) {
-        if(success) {
-            // everything ok - remove the backup
-            QFile file(tmpPath);
-            file.remove();
-        } else if(originalExists) {
-            // revert on fail
-            QFile::remove(mDocInfo->filePath());
-            QFile::copy(tmpPath, mDocInfo->filePath());
-            QFile::remove(tmpPath);
-        }
-    }
+    int quality = ImageLib::defaultSaveQuality(QFileInfo(destPath).suffix());
+    bool success = ImageLib::save(commitEdits(), destPath, quality);
     if(destPath == mPath && success)
         mDocInfo->refresh();
     return success;
@@ -134,30 +189,50 @@ bool ImageStatic::save() {
     return save(mPath);
 }
 
+// may be downscaled; size() has the real size
 std::unique_ptr<QPixmap> ImageStatic::getPixmap() {
     std::unique_ptr<QPixmap> pix(new QPixmap());
-    isEdited()?pix->convertFromImage(*imageEdited):pix->convertFromImage(*image, Qt::NoFormatConversion);
+    isEdited()?pix->convertFromImage(*imageEdited):pix->convertFromImage(*getDisplayImage(), Qt::NoFormatConversion);
     return pix;
 }
 
 std::shared_ptr<const QImage> ImageStatic::getSourceImage() {
-    return image;
+    return fullImage();
 }
 
 std::shared_ptr<const QImage> ImageStatic::getImage() {
-    return isEdited()?imageEdited:image;
+    if(isEdited())
+        return imageEdited;
+    return fullImage();
+}
+
+std::shared_ptr<const QImage> ImageStatic::getDisplayImage() {
+    if(isEdited())
+        return imageEdited;
+    QMutexLocker lock(&mutex);
+    if(image)
+        return image;
+    return imageReduced;
+}
+
+bool ImageStatic::isDownscaled() {
+    QMutexLocker lock(&mutex);
+    return !image && !isEdited();
 }
 
 int ImageStatic::height() {
-    return isEdited()?imageEdited->height():image->height();
+    return size().height();
 }
 
 int ImageStatic::width() {
-    return isEdited()?imageEdited->width():image->width();
+    return size().width();
 }
 
 QSize ImageStatic::size() {
-    return isEdited()?imageEdited->size():image->size();
+    if(isEdited())
+        return imageEdited->size();
+    QMutexLocker lock(&mutex);
+    return fullSize;
 }
 
 bool ImageStatic::setEditedImage(std::unique_ptr<const QImage> imageEditedNew) {
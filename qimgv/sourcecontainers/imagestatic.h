@@ -3,6 +3,7 @@
 #include <QImage>
 #include <QImageWriter>
 #include <QSemaphore>
+#include <QMutex>
 #include <QCryptographicHash>
 #include "image.h"
 #include "utils/imagelib.h"
@@ -13,11 +14,16 @@ class ImageStatic : public Image {
 public:
     ImageStatic(QString _path);
     ImageStatic(std::unique_ptr<DocumentInfo> _info);
+    // Decodes at reduced size if that still covers displaySize (device px).
+    // Only for formats which can do that cheaply (jpeg).
+    ImageStatic(std::unique_ptr<DocumentInfo> _info, QSize _displaySize);
     ~ImageStatic();
 
     std::unique_ptr<QPixmap> getPixmap();
     std::shared_ptr<const QImage> getSourceImage();
     std::shared_ptr<const QImage> getImage();
+    std::shared_ptr<const QImage> getDisplayImage();
+    bool isDownscaled();
 
     int height();
     int width();
@@ -25,6 +31,7 @@ public:
 
     bool setEditedImage(std::unique_ptr<const QImage> imageEditedNew);
     bool discardEditedImage();
+    std::shared_ptr<const QImage> commitEdits();
 
 public slots:
     void crop(QRect newRect);
@@ -33,8 +40,15 @@ public slots:
 
 private:
     void load();
-    std::shared_ptr<const QImage> image, imageEdited;
-    void loadGeneric();
+    std::shared_ptr<const QImage> image, imageEdited, imageReduced;
+    QSize displaySize, fullSize;
+    // guards image, imageReduced & fullSize; held only for short reads / swaps
+    QMutex mutex;
+    // the full decode can be triggered from any thread; one at a time
+    QMutex decodeMutex;
+    std::unique_ptr<const QImage> decode(QSize targetSize, QSize &sourceSize, bool &reduced);
+    void loadGeneric(QSize targetSize);
     void loadICO();
-    QString generateHash(QString str);
+    std::shared_ptr<const QImage> fullImage();
+    QSize reducedDecodeSize(QSize source, QSize target) const;
 };
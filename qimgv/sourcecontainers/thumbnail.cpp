@@ -29,3 +29,11 @@ bool Thumbnail::hasAlphaChannel() {
 std::shared_ptr<QPixmap> Thumbnail::pixmap() {
     return mPixmap;
 }
+
+QSize Thumbnail::originalSize() {
+    return mOriginalSize;
+}
+
+void Thumbnail::setOriginalSize(QSize _originalSize) {
+    mOriginalSize = _originalSize;
+}
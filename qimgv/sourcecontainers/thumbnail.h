@@ -12,9 +12,13 @@ public:
     int size();
     bool hasAlphaChannel();
     std::shared_ptr<QPixmap> pixmap();
+    // full size of the source image, as displayed (exif rotation applied)
+    QSize originalSize();
+    void setOriginalSize(QSize _originalSize);
 private:
     QString mName, mInfo;
     std::shared_ptr<QPixmap> mPixmap;
+    QSize mOriginalSize;
     int mSize;
     bool mHasAlphaChannel;
 };
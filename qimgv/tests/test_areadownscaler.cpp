@@ -0,0 +1,80 @@
+#include "test_areadownscaler.h"
+
+#include <QtTest>
+#include "../utils/areadownscaler.h"
+
+QTEST_MAIN(Test_AreaDownscaler);
+
+QImage Test_AreaDownscaler::downscale(const QImage &source, QSize target) const {
+    AreaDownscaler downscaler(source.size(), target);
+    downscaler.addRows(source, 0);
+    return downscaler.result();
+}
+
+// 2x2 blocks of 0, 40, 80, 120 average to 60
+void Test_AreaDownscaler::boxAverage() {
+    QImage source(4, 4, QImage::Format_RGB32);
+    const int values[4] = { 0, 40, 80, 120 };
+    for(int y = 0; y < 4; y++) {
+        for(int x = 0; x < 4; x++) {
+            int v = values[(y % 2) * 2 + x % 2];
+            source.setPixel(x, y, qRgb(v, v, v));
+        }
+    }
+    QImage result = downscale(source, QSize(2, 2));
+    QCOMPARE(result.size(), QSize(2, 2));
+    QCOMPARE(result.format(), QImage::Format_RGB32);
+    for(int y = 0; y < 2; y++)
+        for(int x = 0; x < 2; x++)
+            QCOMPARE(result.pixel(x, y), qRgb(60, 60, 60));
+}
+
+/**
+ * 3 -> 2 in both directions: the middle source row / column is split
+ * in half between the two outputs. With columns 0, 90, 180 that gives
+ * (0 + 45) / 1.5 = 30 and (45 + 180) / 1.5 = 150.
+ */
+void Test_AreaDownscaler::oddRatio() {
+    QImage source(3, 3, QImage::Format_RGB32);
+    for(int y = 0; y < 3; y++)
+        for(int x = 0; x < 3; x++)
+            source.setPixel(x, y, qRgb(x * 90, x * 90, x * 90));
+    QImage result = downscale(source, QSize(2, 2));
+    for(int y = 0; y < 2; y++) {
+        QCOMPARE(qRed(result.pixel(0, y)), 30);
+        QCOMPARE(qRed(result.pixel(1, y)), 150);
+    }
+}
+
+// weights of every output pixel must add up to its area
+void Test_AreaDownscaler::oddRatioKeepsFlatColor() {
+    QImage source(7, 5, QImage::Format_ARGB32);
+    source.fill(qRgba(200, 100, 50, 255));
+    AreaDownscaler downscaler(source.size(), QSize(3, 2));
+    downscaler.addRows(source, 0, 4);
+    QVERIFY(!downscaler.isComplete());
+    downscaler.addRows(source, 4, 1);
+    QVERIFY(downscaler.isComplete());
+    QImage result = downscaler.result();
+    QCOMPARE(result.size(), QSize(3, 2));
+    for(int y = 0; y < 2; y++)
+        for(int x = 0; x < 3; x++)
+            QCOMPARE(result.pixel(x, y), qRgb(200, 100, 50));
+}
+
+void Test_AreaDownscaler::bandsMatchSingleRead() {
+    QImage source(31, 23, QImage::Format_ARGB32_Premultiplied);
+    for(int y = 0; y < source.height(); y++)
+        for(int x = 0; x < source.width(); x++)
+            source.setPixel(x, y, qRgb((x * 37) % 256, (y * 53) % 256, (x * y) % 256));
+    QSize target(7, 5);
+    AreaDownscaler banded(source.size(), target);
+    for(int y = 0; y < source.height(); y += 4) {
+        QImage band = source.copy(0, y, source.width(), qMin(4, source.height() - y));
+        banded.addRows(band, y);
+    }
+    QVERIFY(banded.isComplete());
+    QCOMPARE(banded.result(), downscale(source, target));
+}
+
+#include "test_areadownscaler.moc"
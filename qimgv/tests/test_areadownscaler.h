@@ -0,0 +1,16 @@
+#pragma once
+
+#include <QObject>
+#include <QImage>
+
+class Test_AreaDownscaler : public QObject
+{
+    Q_OBJECT
+private slots:
+    void boxAverage();
+    void oddRatio();
+    void oddRatioKeepsFlatColor();
+    void bandsMatchSingleRead();
+private:
+    QImage downscale(const QImage &source, QSize target) const;
+};
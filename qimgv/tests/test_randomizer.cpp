@@ -0,0 +1,110 @@
+#include "test_randomizer.h"
+
+#include <QtTest>
+#include "../utils/randomizer.h"
+
+QTEST_MAIN(Test_Randomizer);
+
+QStringList Test_Randomizer::items(int count) const {
+    QStringList list;
+    for(int i = 0; i < count; i++)
+        list << QString("file%1.jpg").arg(i);
+    return list;
+}
+
+/**
+ * Full shuffled order right after reset(), when the randomizer sits at slot 0.
+ * next() walks slots 1..n-1, slot 0 is whatever was not returned.
+ */
+QStringList Test_Randomizer::order(Randomizer &randomizer, const QStringList &items) const {
+    QStringList rest;
+    for(int i = 1; i < items.count(); i++)
+        rest << randomizer.next();
+    QStringList first = items;
+    for(auto &item : rest)
+        first.removeOne(item);
+    return first + rest;
+}
+
+void Test_Randomizer::nextPrevAreReversible() {
+    Randomizer randomizer;
+    auto list = items(10);
+    randomizer.reset(list);
+    auto shuffled = order(randomizer, list);
+    QCOMPARE(shuffled.count(), 10);
+    auto sorted = shuffled;
+    std::sort(sorted.begin(), sorted.end());
+    std::sort(list.begin(), list.end());
+    QCOMPARE(sorted, list);
+    // sitting at the last slot; walk all the way back
+    for(int i = 8; i >= 0; i--)
+        QCOMPARE(randomizer.prev(), shuffled.at(i));
+    QVERIFY(randomizer.peekPrev().isEmpty());
+    for(int i = 1; i < 10; i++) {
+        QCOMPARE(randomizer.peekNext(), shuffled.at(i));
+        QCOMPARE(randomizer.next(), shuffled.at(i));
+    }
+}
+
+void Test_Randomizer::removeKeepsOrderAndPosition() {
+    Randomizer randomizer;
+    auto list = items(20);
+    randomizer.reset(list);
+    auto shuffled = order(randomizer, list);
+    QVERIFY(randomizer.setCurrent(shuffled.at(5)));
+    /**
+     * 11 of 20 removed: more than half, so the last remove() compacts
+     */
+    QList<int> removed = { 0, 1, 2, 3, 4, 7, 9, 11, 13, 15, 17 };
+    for(auto i : removed)
+        randomizer.remove(shuffled.at(i));
+    QCOMPARE(randomizer.count(), 9);
+    QVERIFY(randomizer.peekPrev().isEmpty());
+    QList<int> expected = { 6, 8, 10, 12, 14, 16, 18, 19 };
+    for(auto i : expected)
+        QCOMPARE(randomizer.next(), shuffled.at(i));
+    for(int j = expected.count() - 2; j >= 0; j--)
+        QCOMPARE(randomizer.prev(), shuffled.at(expected.at(j)));
+    QCOMPARE(randomizer.prev(), shuffled.at(5));
+    QVERIFY(!randomizer.setCurrent(shuffled.at(7)));
+}
+
+void Test_Randomizer::renameKeepsSlot() {
+    Randomizer randomizer;
+    auto list = items(10);
+    randomizer.reset(list);
+    auto shuffled = order(randomizer, list);
+    randomizer.rename(shuffled.at(6), "renamed.jpg");
+    QCOMPARE(randomizer.count(), 10);
+    QVERIFY(!randomizer.setCurrent(shuffled.at(6)));
+    QVERIFY(randomizer.setCurrent(shuffled.at(5)));
+    QCOMPARE(randomizer.next(), QString("renamed.jpg"));
+    QCOMPARE(randomizer.next(), shuffled.at(7));
+    QCOMPARE(randomizer.prev(), QString("renamed.jpg"));
+    QCOMPARE(randomizer.prev(), shuffled.at(5));
+}
+
+void Test_Randomizer::insertGoesAhead() {
+    Randomizer randomizer;
+    auto list = items(10);
+    randomizer.reset(list);
+    auto shuffled = order(randomizer, list);
+    QVERIFY(randomizer.setCurrent(shuffled.at(5)));
+    randomizer.insert("new.jpg");
+    randomizer.insert("new.jpg");
+    QCOMPARE(randomizer.count(), 11);
+    // history is untouched
+    for(int i = 4; i >= 0; i--)
+        QCOMPARE(randomizer.prev(), shuffled.at(i));
+    QVERIFY(randomizer.setCurrent(shuffled.at(5)));
+    // the new file is somewhere among the ones not visited yet
+    QStringList upcoming;
+    for(int i = 0; i < 5; i++)
+        upcoming << randomizer.next();
+    QStringList expected = shuffled.mid(6) << "new.jpg";
+    std::sort(upcoming.begin(), upcoming.end());
+    std::sort(expected.begin(), expected.end());
+    QCOMPARE(upcoming, expected);
+}
+
+#include "test_randomizer.moc"
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <QObject>
+#include <QStringList>
+
+class Randomizer;
+
+class Test_Randomizer : public QObject
+{
+    Q_OBJECT
+private slots:
+    void nextPrevAreReversible();
+    void removeKeepsOrderAndPosition();
+    void renameKeepsSlot();
+    void insertGoesAhead();
+private:
+    QStringList items(int count) const;
+    QStringList order(Randomizer &randomizer, const QStringList &items) const;
+};
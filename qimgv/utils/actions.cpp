@@ -90,5 +90,7 @@ void Actions::init() {
     mActions.insert("print", QVersionNumber(1,0,0));
     mActions.insert("toggleFullscreenInfoBar", QVersionNumber(1,0,0));
     mActions.insert("pasteFile", QVersionNumber(1,0,3));
+    mActions.insert("cancelFileOperations", QVersionNumber(1,0,3));
+    mActions.insert("togglePerfOverlay", QVersionNumber(1,0,3));
 }
 
@@ -0,0 +1,130 @@
+#include "areadownscaler.h"
+
+// rows converted at once when the source is not in argb32 already
+#define CONVERT_ROWS 64
+
+AreaDownscaler::AreaDownscaler(QSize _sourceSize, QSize _targetSize)
+    : sourceSize(_sourceSize),
+      targetSize(_targetSize),
+      nextRow(0),
+      currentOutRow(0),
+      hasAlpha(false)
+{
+    // a source pixel covers [x, x + 1) which is [x / scale, (x + 1) / scale)
+    // in the output; when downscaling that is never more than two pixels
+    auto map = [](int sourceLength, int targetLength, std::vector<int> &index, std::vector<float> &weight) {
+        double scale = static_cast<double>(sourceLength) / targetLength;
+        index.resize(sourceLength);
+        weight.resize(sourceLength);
+        for(int i = 0; i < sourceLength; i++) {
+            double start = i / scale;
+            int out = qMin(static_cast<int>(start), targetLength - 1);
+            double end = (i + 1) / scale;
+            index[i] = out;
+            if(end <= out + 1 || out == targetLength - 1)
+                weight[i] = 1.0f;
+            else
+                weight[i] = static_cast<float>((out + 1 - start) * scale);
+        }
+    };
+    map(sourceSize.width(), targetSize.width(), columnIndex, columnWeight);
+    map(sourceSize.height(), targetSize.height(), rowIndex, rowWeight);
+    for(auto &accumulator : accumulators)
+        accumulator.assign(static_cast<size_t>(targetSize.width()) * 4, 0.0f);
+    horizontal.assign(static_cast<size_t>(targetSize.width()) * 4, 0.0f);
+    output = QImage(targetSize, QImage::Format_ARGB32_Premultiplied);
+}
+
+bool AreaDownscaler::canDownscale(QSize sourceSize, QSize targetSize) {
+    return !targetSize.isEmpty() &&
+           targetSize.width() <= sourceSize.width() &&
+           targetSize.height() <= sourceSize.height();
+}
+
+bool AreaDownscaler::isComplete() const {
+    return nextRow >= sourceSize.height();
+}
+
+void AreaDownscaler::addRows(const QImage &band, int firstRow) {
+    if(firstRow != nextRow)
+        return;
+    addRows(band, 0, band.height());
+}
+
+// fromRow is a row of the image, which continues where the last call stopped
+void AreaDownscaler::addRows(const QImage &image, int fromRow, int count) {
+    if(image.width() != sourceSize.width())
+        return;
+    count = qMin(count, qMin(image.height() - fromRow, sourceSize.height() - nextRow));
+    if(image.format() == QImage::Format_ARGB32_Premultiplied || image.format() == QImage::Format_RGB32) {
+        for(int y = fromRow; y < fromRow + count; y++)
+            addRow(reinterpret_cast<const QRgb*>(image.constScanLine(y)));
+        return;
+    }
+    // anything else is converted a few rows at a time,
+    // never the whole image (indexed pngs would double in size)
+    for(int y = fromRow; y < fromRow + count; y += CONVERT_ROWS) {
+        int rows = qMin(CONVERT_ROWS, fromRow + count - y);
+        QImage converted = image.copy(0, y, image.width(), rows).convertToFormat(QImage::Format_ARGB32_Premultiplied);
+        for(int i = 0; i < rows; i++)
+            addRow(reinterpret_cast<const QRgb*>(converted.constScanLine(i)));
+    }
+}
+
+void AreaDownscaler::addRow(const QRgb *row) {
+    std::fill(horizontal.begin(), horizontal.end(), 0.0f);
+    for(int x = 0; x < sourceSize.width(); x++) {
+        QRgb pixel = row[x];
+        if(qAlpha(pixel) != 255)
+            hasAlpha = true;
+        float channels[4] = { float(qAlpha(pixel)), float(qRed(pixel)), float(qGreen(pixel)), float(qBlue(pixel)) };
+        float weight = columnWeight[x];
+        float *out = &horizontal[static_cast<size_t>(columnIndex[x]) * 4];
+        for(int c = 0; c < 4; c++)
+            out[c] += channels[c] * weight;
+        if(weight < 1.0f) {
+            for(int c = 0; c < 4; c++)
+                out[c + 4] += channels[c] * (1.0f - weight);
+        }
+    }
+    int outRow = rowIndex[nextRow];
+    // everything above is complete
+    while(currentOutRow < outRow)
+        finishRow(currentOutRow);
+    float weight = rowWeight[nextRow];
+    auto &first = accumulators[outRow % 2];
+    for(size_t i = 0; i < horizontal.size(); i++)
+        first[i] += horizontal[i] * weight;
+    if(weight < 1.0f) {
+        auto &second = accumulators[(outRow + 1) % 2];
+        for(size_t i = 0; i < horizontal.size(); i++)
+            second[i] += horizontal[i] * (1.0f - weight);
+    }
+    nextRow++;
+}
+
+void AreaDownscaler::finishRow(int outRow) {
+    auto &accumulator = accumulators[outRow % 2];
+    float area = static_cast<float>(sourceSize.width()) / targetSize.width() *
+                 static_cast<float>(sourceSize.height()) / targetSize.height();
+    QRgb *line = reinterpret_cast<QRgb*>(output.scanLine(outRow));
+    for(int x = 0; x < targetSize.width(); x++) {
+        const float *in = &accumulator[static_cast<size_t>(x) * 4];
+        int a = qBound(0, qRound(in[0] / area), 255);
+        // premultiplied; color can't exceed alpha
+        int r = qBound(0, qRound(in[1] / area), a);
+        int g = qBound(0, qRound(in[2] / area), a);
+        int b = qBound(0, qRound(in[3] / area), a);
+        line[x] = qRgba(r, g, b, a);
+    }
+    std::fill(accumulator.begin(), accumulator.end(), 0.0f);
+    currentOutRow = outRow + 1;
+}
+
+QImage AreaDownscaler::result() {
+    while(currentOutRow < targetSize.height())
+        finishRow(currentOutRow);
+    if(!hasAlpha)
+        return output.convertToFormat(QImage::Format_RGB32);
+    return output;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <QImage>
+#include <QSize>
+#include <vector>
+#include <algorithm>
+
+// Area-averaging (box filter) downscaler that takes the source a band of
+// rows at a time, top to bottom. Only two rows of the output are kept
+// in progress, so memory depends on the output size and the band size,
+// not on the source.
+//
+// Works in premultiplied argb; bands may come in any format.
+class AreaDownscaler {
+public:
+    // target must not be larger than source in either dimension
+    AreaDownscaler(QSize _sourceSize, QSize _targetSize);
+
+    // rows [firstRow, firstRow + band.height()) of the source
+    void addRows(const QImage &band, int firstRow);
+    // count rows of a bigger image starting at fromRow,
+    // which go right after the ones added before
+    void addRows(const QImage &image, int fromRow, int count);
+    bool isComplete() const;
+    // ARGB32_Premultiplied, or RGB32 if nothing had alpha
+    QImage result();
+
+    static bool canDownscale(QSize sourceSize, QSize targetSize);
+
+private:
+    void addRow(const QRgb *row);
+    void finishRow(int outRow);
+
+    QSize sourceSize, targetSize;
+    // where every source column / row goes: output index,
+    // and the part of it that falls there (the rest goes to the next one)
+    std::vector<int> columnIndex, rowIndex;
+    std::vector<float> columnWeight, rowWeight;
+    // two output rows in progress, 4 channels each
+    std::vector<float> accumulators[2];
+    std::vector<float> horizontal;
+    int nextRow, currentOutRow;
+    bool hasAlpha;
+    QImage output;
+};
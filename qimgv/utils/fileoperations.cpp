@@ -1,5 +1,15 @@
 #include "fileoperations.h"
 
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
+#elif !defined(Q_OS_WIN32)
+#include <cstdio>
+#endif
+
 QString FileOperations::generateHash(const QString &str) {
     return QString(QCryptographicHash::hash(str.toUtf8(), QCryptographicHash::Md5).toHex());
 }
@@ -57,15 +67,16 @@ QString FileOperations::decodeResult(const FileOpResult &result) {
         return QObject::tr("Directory is not empty.");
     case FileOpResult::NOTHING_TO_DO:
         return QObject::tr("Nothing to do.");
+    case FileOpResult::CANCELED:
+        return QObject::tr("Operation canceled.");
     case FileOpResult::OTHER_ERROR:
         return QObject::tr("Other error.");
     }
     return nullptr;
 }
 
-void FileOperations::copyFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result) {
+void FileOperations::copyFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result, const QAtomicInt *abortFlag) {
     QFileInfo srcFile(srcFilePath);
-    QString tmpPath;
     bool exists = false;
     // error checks
     if(destDirPath == srcFile.absolutePath()) {
@@ -101,17 +112,13 @@ void FileOperations::copyFileTo(const QString &srcFilePath, const QString &destD
             result = FileOpResult::DESTINATION_FILE_EXISTS;
             return;
         }
-        // remove just in case it exists
-        tmpPath = destFile.absoluteFilePath() + "_" + generateHash(destFile.absoluteFilePath());
-        QFile::remove(tmpPath);
-        // move backup
-        QFile::rename(destFile.absoluteFilePath(), tmpPath);
         exists = true;
     }
     // copy
+    // when overwriting, the destination is replaced atomically; it stays intact on failure
     auto srcModTime = srcFile.lastModified();
     auto srcReadTime = srcFile.lastRead();
-    if(QFile::copy(srcFile.absoluteFilePath(), destFile.absoluteFilePath())) {
+    if(copyFile(srcFile.absoluteFilePath(), destFile.absoluteFilePath(), exists, abortFlag)) {
         result = FileOpResult::SUCCESS;
         // restore timestamps
         QFile dstF(destFile.absoluteFilePath());
@@ -119,20 +126,14 @@ void FileOperations::copyFileTo(const QString &srcFilePath, const QString &destD
         dstF.setFileTime(srcModTime, QFileDevice::FileModificationTime);
         dstF.setFileTime(srcReadTime, QFileDevice::FileAccessTime);
         dstF.close();
-        // ok; remove the backup
-        if(exists)
-            QFile::remove(tmpPath);
     } else {
-        result = FileOpResult::OTHER_ERROR;
-        // fail; revert
-        QFile::rename(tmpPath, destFile.absoluteFilePath());
+        result = (abortFlag && abortFlag->loadAcquire()) ? FileOpResult::CANCELED : FileOpResult::OTHER_ERROR;
     }
     return;
 }
 
-void FileOperations::moveFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result) {
+void FileOperations::moveFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result, const QAtomicInt *abortFlag) {
     QFileInfo srcFile(srcFilePath);
-    QString tmpPath;
     bool exists = false;
     // error checks
     if(destDirPath == srcFile.absolutePath()) {
@@ -174,16 +175,23 @@ void FileOperations::moveFileTo(const QString &srcFilePath, const QString &destD
             result = FileOpResult::DESTINATION_FILE_EXISTS;
             return;
         }
-        tmpPath = destFile.absoluteFilePath() + "_" + generateHash(destFile.absoluteFilePath());
-        QFile::remove(tmpPath);
-        // move backup
-        QFile::rename(destFile.absoluteFilePath(), tmpPath);
+        // there is no backup of the replaced file, so make sure
+        // we will be able to remove the source before touching anything
+        if(!QFileInfo(srcFile.absolutePath()).isWritable()) {
+            result = FileOpResult::SOURCE_NOT_WRITABLE;
+            return;
+        }
         exists = true;
     }
+    // same filesystem: a plain rename, timestamps are kept as is
+    if(renameFile(srcFile.absoluteFilePath(), destFile.absoluteFilePath(), exists)) {
+        result = FileOpResult::SUCCESS;
+        return;
+    }
     // move
     auto srcModTime = srcFile.lastModified();
     auto srcReadTime = srcFile.lastRead();
-    if(QFile::copy(srcFile.absoluteFilePath(), destFile.absoluteFilePath())) {
+    if(copyFile(srcFile.absoluteFilePath(), destFile.absoluteFilePath(), exists, abortFlag)) {
         // remove original file
         FileOpResult removeResult;
         removeFile(srcFile.absoluteFilePath(), removeResult);
@@ -197,21 +205,17 @@ void FileOperations::moveFileTo(const QString &srcFilePath, const QString &destD
             dstF.setFileTime(srcModTime, QFileDevice::FileModificationTime);
             dstF.setFileTime(srcReadTime, QFileDevice::FileAccessTime);
             dstF.close();
-            // remove backup
-            if(exists)
-                QFile::remove(tmpPath);
             return;
         }
         // revert on failure
+        // (an overwritten destination keeps the new contents, the source is still there)
         result = FileOpResult::SOURCE_NOT_WRITABLE;
-        if(QFile::remove(destFile.absoluteFilePath()))
+        if(!exists && QFile::remove(destFile.absoluteFilePath()))
             result = FileOpResult::OTHER_ERROR;
     } else {
         // could not COPY
-        result = FileOpResult::OTHER_ERROR;
+        result = (abortFlag && abortFlag->loadAcquire()) ? FileOpResult::CANCELED : FileOpResult::OTHER_ERROR;
     }
-    if(exists) // failed; revert backup
-        QFile::rename(tmpPath, destFile.absoluteFilePath());
     return;
 }
 
@@ -264,6 +268,103 @@ void FileOperations::rename(const QString &srcFilePath, const QString &newName,
     }
 }
 
+// Overwrites go through QSaveFile (temporary file next to the destination,
+// synced to disk and atomically renamed over it), falling back to a direct
+// write when the destination directory doesn't allow creating the temp file.
+// New files are written in place and removed again if anything goes wrong.
+bool FileOperations::copyFile(const QString &srcFilePath, const QString &destFilePath, bool overwrite, const QAtomicInt *abortFlag) {
+    QFile src(srcFilePath);
+    if(!src.open(QIODevice::ReadOnly))
+        return false;
+    if(overwrite) {
+        QSaveFile dest(destFilePath);
+        dest.setDirectWriteFallback(true);
+        if(!dest.open(QIODevice::WriteOnly))
+            return false;
+        if(!copyFileData(src, dest, abortFlag)) {
+            dest.cancelWriting();
+            return false;
+        }
+        if(!dest.commit())
+            return false;
+    } else {
+        QFile dest(destFilePath);
+        if(!dest.open(QIODevice::WriteOnly | QIODevice::NewOnly))
+            return false;
+        if(!copyFileData(src, dest, abortFlag) || !dest.flush()) {
+            dest.close();
+            dest.remove();
+            return false;
+        }
+        dest.close();
+    }
+    QFile::setPermissions(destFilePath, src.permissions());
+    return true;
+}
+
+// Tries a reflink, then an in-kernel copy, then falls back to read()/write().
+// Checks abortFlag between chunks so that big files can be canceled mid-way.
+bool FileOperations::copyFileData(QFileDevice &src, QFileDevice &dest, const QAtomicInt *abortFlag) {
+#ifdef Q_OS_LINUX
+    int srcFd = src.handle();
+    int destFd = dest.handle();
+#ifdef FICLONE
+    // btrfs, xfs etc: shares extents with the source, no data is copied at all
+    if(ioctl(destFd, FICLONE, srcFd) == 0)
+        return true;
+#endif
+#ifdef __GLIBC__
+#if __GLIBC_PREREQ(2, 27)
+    const qint64 srcSize = src.size();
+    qint64 remaining = srcSize;
+    bool fallback = false;
+    while(remaining > 0) {
+        if(abortFlag && abortFlag->loadAcquire())
+            return false;
+        ssize_t copied = copy_file_range(srcFd, nullptr, destFd, nullptr,
+                                         static_cast<size_t>(qMin<qint64>(remaining, COPY_CHUNK_SIZE)), 0);
+        if(copied < 0) {
+            // not supported for this pair of files (cross-device on older kernels, fuse, etc)
+            if(remaining == srcSize && (errno == EXDEV || errno == ENOSYS || errno == EINVAL || errno == EOPNOTSUPP)) {
+                fallback = true;
+                break;
+            }
+            return false;
+        }
+        if(copied == 0) // file got truncated while we were copying; take what we have
+            break;
+        remaining -= copied;
+    }
+    if(!fallback)
+        return true;
+#endif
+#endif
+#endif
+    QByteArray buf(COPY_CHUNK_SIZE, Qt::Uninitialized);
+    qint64 bytesRead;
+    while((bytesRead = src.read(buf.data(), buf.size())) > 0) {
+        if(abortFlag && abortFlag->loadAcquire())
+            return false;
+        if(dest.write(buf.constData(), bytesRead) != bytesRead)
+            return false;
+    }
+    return bytesRead == 0;
+}
+
+// Only succeeds when source and destination are on the same filesystem.
+bool FileOperations::renameFile(const QString &srcFilePath, const QString &destFilePath, bool overwrite) {
+    if(!overwrite)
+        return QDir().rename(srcFilePath, destFilePath);
+#ifdef Q_OS_WIN32
+    return MoveFileExW(reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(srcFilePath).utf16()),
+                       reinterpret_cast<LPCWSTR>(QDir::toNativeSeparators(destFilePath).utf16()),
+                       MOVEFILE_REPLACE_EXISTING);
+#else
+    // rename(2) atomically replaces the destination
+    return ::rename(QFile::encodeName(srcFilePath).constData(), QFile::encodeName(destFilePath).constData()) == 0;
+#endif
+}
+
 void FileOperations::moveToTrash(const QString &filePath, FileOpResult &result) {
     QFileInfo file(filePath);
     if(!file.exists()) {
@@ -4,6 +4,8 @@
 #include <QDebug>
 #include <QString>
 #include <QFileInfo>
+#include <QSaveFile>
+#include <QAtomicInt>
 #include <QDir>
 #include <QDateTime>
 #include <QStandardPaths>
@@ -23,13 +25,15 @@ enum FileOpResult {
     DESTINATION_DOES_NOT_EXIST,
     DIRECTORY_NOT_EMPTY,
     NOTHING_TO_DO, // todo: maybe just return SUCCESS?
+    CANCELED,
     OTHER_ERROR
 };
 
 class FileOperations {
 public:
-    static void copyFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result);
-    static void moveFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result);
+    // abortFlag lets another thread interrupt a copy that is in progress
+    static void copyFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result, const QAtomicInt *abortFlag = nullptr);
+    static void moveFileTo(const QString &srcFilePath, const QString &destDirPath, bool force, FileOpResult &result, const QAtomicInt *abortFlag = nullptr);
     static void rename(const QString &srcFilePath, const QString &newName, bool force, FileOpResult &result);
     static void removeFile(const QString &filePath, FileOpResult &result);
     static void removeDir(const QString &dirPath, bool recursive, FileOpResult &result);
@@ -39,5 +43,9 @@ public:
 
 private:
     static bool moveToTrashImpl(const QString &path);
+    static bool copyFile(const QString &srcFilePath, const QString &destFilePath, bool overwrite, const QAtomicInt *abortFlag);
+    static bool copyFileData(QFileDevice &src, QFileDevice &dest, const QAtomicInt *abortFlag);
+    static bool renameFile(const QString &srcFilePath, const QString &destFilePath, bool overwrite);
+    static const int COPY_CHUNK_SIZE = 4 * 1024 * 1024;
     static QString generateHash(const QString &str);
 };
@@ -1,8 +1,13 @@
 #include "imagefactory.h"
 
-std::shared_ptr<Image> ImageFactory::createImage(QString path) {
-    std::unique_ptr<DocumentInfo> docInfo(new DocumentInfo(path));
+std::shared_ptr<Image> ImageFactory::createImage(QString path, QSize displaySize) {
+    std::unique_ptr<DocumentInfo> docInfo;
+    {
+        PerfScope scope("probe", path);
+        docInfo.reset(new DocumentInfo(path));
+    }
     std::shared_ptr<Image> img = nullptr;
+    PerfScope scope("decode", path);
     if(docInfo->type() == NONE) {
         qDebug() << "ImageFactory: cannot load " << docInfo->filePath();
     } else if(docInfo->type() == ANIMATED) {
@@ -10,7 +15,7 @@ std::shared_ptr<Image> ImageFactory::createImage(QString path) {
     } else if(docInfo->type() == VIDEO) {
         img.reset(new Video(move(docInfo)));
     } else {
-        img.reset(new ImageStatic(move(docInfo)));
+        img.reset(new ImageStatic(move(docInfo), displaySize));
     }
     return img;
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "utils/imagelib.h"
+#include "utils/perftrace.h"
 #include "sourcecontainers/documentinfo.h"
 #include "sourcecontainers/image.h"
 #include "sourcecontainers/imageanimated.h"
@@ -9,5 +10,6 @@
 
 class ImageFactory {
 public:
-    static std::shared_ptr<Image> createImage(QString path);
+    // displaySize: decode static images just large enough for this (device px)
+    static std::shared_ptr<Image> createImage(QString path, QSize displaySize = QSize());
 };
@@ -58,6 +58,45 @@ QImage* ImageLib::flippedV(std::shared_ptr<const QImage> src) {
     return flippedVRaw(src.get());
 }
 //------------------------------------------------------------------------------
+// Encodes into a temporary file in the destination directory, syncs it to disk
+// and then atomically renames it over destPath (QSaveFile does all of that).
+// The existing file is either fully replaced or left untouched.
+// If the directory is not writable (temp file can't be created) it falls back
+// to writing destPath directly, which loses the atomicity but not the save.
+bool ImageLib::saveRaw(const QImage *src, const QString &destPath, int quality) {
+    if(!src || src->isNull())
+        return false;
+    QSaveFile file(destPath);
+    file.setDirectWriteFallback(true);
+    if(!file.open(QIODevice::WriteOnly)) {
+        qDebug() << "ImageLib::save() - could not open" << destPath << ":" << file.errorString();
+        return false;
+    }
+    QImageWriter writer(&file, QFileInfo(destPath).suffix().toLatin1());
+    writer.setQuality(quality);
+    if(!writer.write(*src)) {
+        qDebug() << "ImageLib::save() - could not write" << destPath << ":" << writer.errorString();
+        file.cancelWriting();
+        return false;
+    }
+    return file.commit();
+}
+//------------------------------------------------------------------------------
+bool ImageLib::save(std::shared_ptr<const QImage> src, const QString &destPath, int quality) {
+    return saveRaw(src.get(), destPath, quality);
+}
+//------------------------------------------------------------------------------
+int ImageLib::defaultSaveQuality(const QString &suffix) {
+    // png compression note from libpng
+    // Note that tests have shown that zlib compression levels 3-6 usually perform as well
+    // as level 9 for PNG images, and do considerably fewer caclulations
+    if(suffix.compare("png", Qt::CaseInsensitive) == 0)
+        return 30;
+    if(suffix.compare("jpg", Qt::CaseInsensitive) == 0 || suffix.compare("jpeg", Qt::CaseInsensitive) == 0)
+        return settings->JPEGSaveQuality();
+    return 95;
+}
+//------------------------------------------------------------------------------
 std::unique_ptr<const QImage> ImageLib::exifRotated(std::unique_ptr<const QImage> src, int orientation) {
     switch(orientation) {
     case 1: {
@@ -218,7 +257,6 @@ QImage* ImageLib::scaled_CV(std::shared_ptr<const QImage> source, QSize destSize
             *dest = QtOcv::mat2Image(dstMat_sharpened, order, source->format());
         }
     }
-    //qDebug() << "Filter:" << filter << " sharpen=" << sharpen << " source size:" << source->size() << "->" << (float)destSize.width() / source->width() << ": " << t.elapsed() << " ms.";
     return dest;
 }
 #endif
@@ -6,6 +6,9 @@
 #include <memory>
 #include <QElapsedTimer>
 #include <QProcess>
+#include <QSaveFile>
+#include <QImageWriter>
+#include <QFileInfo>
 #include "sourcecontainers/documentinfo.h"
 #include "settings.h"
 
@@ -40,4 +43,8 @@ class ImageLib {
         static std::unique_ptr<const QImage> exifRotated(std::unique_ptr<const QImage> src, int orientation);
         static std::unique_ptr<QImage> exifRotated(std::unique_ptr<QImage> src, int orientation);
         static void recolor(QPixmap &pixmap, QColor color);
+
+        static bool saveRaw(const QImage *src, const QString &destPath, int quality);
+        static bool save(std::shared_ptr<const QImage> src, const QString &destPath, int quality);
+        static int defaultSaveQuality(const QString &suffix);
 };
@@ -0,0 +1,120 @@
+#include "mappedfile.h"
+#include <limits>
+#include <QDateTime>
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(QString _path)
+    : mPath(_path),
+      mData(nullptr),
+      mSize(0)
+{
+#ifdef Q_OS_UNIX
+    int fd = ::open(QFile::encodeName(mPath).constData(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return;
+    struct stat st;
+    // QByteArray views are int-sized on qt5; anything bigger is read normally
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0 && st.st_size <= std::numeric_limits<int>::max()) {
+        if(QDateTime::currentSecsSinceEpoch() - st.st_mtime < MAP_MIN_AGE) {
+            ::close(fd);
+            return;
+        }
+        void *ptr = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if(ptr != MAP_FAILED) {
+            mData = static_cast<uchar*>(ptr);
+            mSize = st.st_size;
+            // decoders read front to back
+            madvise(mData, static_cast<size_t>(mSize), MADV_SEQUENTIAL);
+        } else {
+            qDebug() << "[MappedFile] could not map" << mPath << "- using regular reads";
+        }
+    }
+    // mapping stays valid without the descriptor
+    ::close(fd);
+#else
+    if(QFileInfo(mPath).lastModified().secsTo(QDateTime::currentDateTime()) < MAP_MIN_AGE)
+        return;
+    file.setFileName(mPath);
+    if(file.open(QIODevice::ReadOnly) && file.size() > 0 && file.size() <= std::numeric_limits<int>::max()) {
+        mData = file.map(0, file.size());
+        if(mData)
+            mSize = file.size();
+        else
+            qDebug() << "[MappedFile] could not map" << mPath << "- using regular reads";
+    }
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef Q_OS_UNIX
+    if(mData)
+        munmap(mData, static_cast<size_t>(mSize));
+#endif
+    // QFile unmaps on destruction
+}
+
+QString MappedFile::path() const {
+    return mPath;
+}
+
+bool MappedFile::isMapped() const {
+    return mData != nullptr;
+}
+
+qint64 MappedFile::size() const {
+    return mSize;
+}
+
+const uchar *MappedFile::data() const {
+    return mData;
+}
+
+QByteArray MappedFile::head(qint64 len) const {
+    if(isMapped())
+        return QByteArray::fromRawData(reinterpret_cast<const char*>(mData), static_cast<int>(qMin(len, mSize)));
+    QFile f(mPath);
+    if(!f.open(QIODevice::ReadOnly))
+        return QByteArray();
+    return f.read(len);
+}
+
+std::unique_ptr<QIODevice> MappedFile::device() const {
+    if(isMapped()) {
+        // QBuffer keeps a shallow copy; fromRawData() never copies the bytes
+        auto buffer = new QBuffer();
+        buffer->setData(QByteArray::fromRawData(reinterpret_cast<const char*>(mData), static_cast<int>(mSize)));
+        buffer->open(QIODevice::ReadOnly);
+        return std::unique_ptr<QIODevice>(buffer);
+    }
+    auto f = new QFile(mPath);
+    f->open(QIODevice::ReadOnly);
+    return std::unique_ptr<QIODevice>(f);
+}
+
+void MappedFile::willNeed() const {
+#ifdef Q_OS_UNIX
+    if(mData)
+        madvise(mData, static_cast<size_t>(mSize), MADV_WILLNEED);
+#endif
+}
+
+void MappedFile::prefetch(QString path) {
+#if defined(Q_OS_UNIX) && defined(POSIX_FADV_WILLNEED)
+    int fd = ::open(QFile::encodeName(path).constData(), O_RDONLY | O_CLOEXEC);
+    if(fd < 0)
+        return;
+    struct stat st;
+    if(fstat(fd, &st) == 0 && S_ISREG(st.st_mode))
+        posix_fadvise(fd, 0, static_cast<off_t>(qMin<qint64>(st.st_size, PREFETCH_LIMIT)), POSIX_FADV_WILLNEED);
+    ::close(fd);
+#else
+    Q_UNUSED(path)
+#endif
+}
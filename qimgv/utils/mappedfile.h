@@ -0,0 +1,58 @@
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QBuffer>
+#include <QFile>
+#include <QIODevice>
+#include <QDebug>
+#include <memory>
+
+// Read-only memory mapping of a whole file.
+//
+// One mapping is shared by format detection, exif parsing and decoding,
+// so the file is opened once and read straight from the page cache
+// instead of through QFile's buffer.
+// Keep it only for the duration of one decode or probe: if the file gets
+// truncated by someone else while mapped, touching the missing pages
+// raises SIGBUS. Files modified just now are likely still being written,
+// so those are never mapped.
+//
+// Falls back to regular file reads when mapping fails or is skipped
+// (empty file, fresh file, no address space, etc.); the interface stays the same.
+class MappedFile {
+public:
+    explicit MappedFile(QString _path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile &operator=(const MappedFile&) = delete;
+
+    QString path() const;
+    bool isMapped() const;
+    qint64 size() const;
+    const uchar *data() const;
+
+    // first len bytes (less if the file is shorter). No copy when mapped
+    QByteArray head(qint64 len) const;
+    // new read-only device positioned at 0; for QImageReader.
+    // Must not outlive this object.
+    std::unique_ptr<QIODevice> device() const;
+    // about to read all of it; ask the kernel to start paging it in
+    void willNeed() const;
+
+    // Start reading a file into the page cache in background
+    // without mapping it. For files we are going to open soon.
+    static void prefetch(QString path);
+
+private:
+    QString mPath;
+    uchar *mData;
+    qint64 mSize;
+#ifndef Q_OS_UNIX
+    QFile file;
+#endif
+    // prefetch() does not go further than this
+    static constexpr qint64 PREFETCH_LIMIT = 64 * 1024 * 1024;
+    // files changed more recently than this are read, not mapped
+    static constexpr qint64 MAP_MIN_AGE = 5; // s
+};
@@ -0,0 +1,102 @@
+#include "perftrace.h"
+
+std::atomic<bool> PerfTrace::active(false);
+
+PerfTrace::PerfTrace() : collecting(false) {
+    clock.start();
+}
+
+PerfTrace *PerfTrace::getInstance() {
+    static PerfTrace instance;
+    return &instance;
+}
+
+qint64 PerfTrace::now() const {
+    return clock.nsecsElapsed() / 1000;
+}
+
+void PerfTrace::setTraceFile(QString path) {
+    QMutexLocker lock(&mutex);
+    traceFile = path;
+    updateActive();
+}
+
+void PerfTrace::setCollecting(bool mode) {
+    QMutexLocker lock(&mutex);
+    collecting = mode;
+    updateActive();
+}
+
+void PerfTrace::updateActive() {
+    active.store(collecting || !traceFile.isEmpty(), std::memory_order_relaxed);
+}
+
+void PerfTrace::addEvent(const char *name, const QString &detail, qint64 start, qint64 duration) {
+    QMutexLocker lock(&mutex);
+    last.insert(QString::fromLatin1(name), duration);
+    if(!traceFile.isEmpty() && events.size() < MAX_EVENTS)
+        events.push_back({ name, detail, start, duration, reinterpret_cast<quintptr>(QThread::currentThreadId()) });
+}
+
+void PerfTrace::count(const char *name) {
+    qint64 t = now();
+    QMutexLocker lock(&mutex);
+    qint64 value = ++counts[QString::fromLatin1(name)];
+    if(!traceFile.isEmpty() && events.size() < MAX_EVENTS)
+        events.push_back({ name, QString::number(value), t, -1, 0 });
+}
+
+QMap<QString, qint64> PerfTrace::lastTimings() {
+    QMutexLocker lock(&mutex);
+    QMap<QString, qint64> map;
+    for(auto it = last.constBegin(); it != last.constEnd(); ++it)
+        map.insert(it.key(), it.value());
+    return map;
+}
+
+QMap<QString, qint64> PerfTrace::counters() {
+    QMutexLocker lock(&mutex);
+    QMap<QString, qint64> map;
+    for(auto it = counts.constBegin(); it != counts.constEnd(); ++it)
+        map.insert(it.key(), it.value());
+    return map;
+}
+
+// https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+bool PerfTrace::writeTrace() {
+    QMutexLocker lock(&mutex);
+    if(traceFile.isEmpty())
+        return false;
+    qint64 pid = QCoreApplication::applicationPid();
+    QJsonArray traceEvents;
+    for(auto &e : events) {
+        QJsonObject obj;
+        obj.insert("name", QString::fromLatin1(e.name));
+        obj.insert("cat", "qimgv");
+        obj.insert("pid", pid);
+        obj.insert("tid", static_cast<qint64>(e.thread));
+        obj.insert("ts", e.start);
+        if(e.duration < 0) {
+            // counter
+            obj.insert("ph", "C");
+            obj.insert("args", QJsonObject{{ "value", e.detail.toLongLong() }});
+        } else {
+            obj.insert("ph", "X");
+            obj.insert("dur", e.duration);
+            if(!e.detail.isEmpty())
+                obj.insert("args", QJsonObject{{ "detail", e.detail }});
+        }
+        traceEvents.append(obj);
+    }
+    QJsonObject root;
+    root.insert("traceEvents", traceEvents);
+    root.insert("displayTimeUnit", "ms");
+    QFile file(traceFile);
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qDebug() << "[PerfTrace] Could not write" << traceFile << file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+    qDebug() << "[PerfTrace] Wrote" << events.size() << "events to" << traceFile;
+    return true;
+}
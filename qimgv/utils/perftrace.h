@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QHash>
+#include <QMap>
+#include <QFile>
+#include <QThread>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QCoreApplication>
+#include <QDebug>
+#include <atomic>
+#include <vector>
+
+struct PerfEvent {
+    const char *name;
+    QString detail;
+    qint64 start; // us since startup
+    qint64 duration; // us; -1 for counters
+    quintptr thread;
+};
+
+// Timing probes for the slow parts (decoding, scaling, scans, caches).
+//
+// Does nothing until something asks for data: either a trace file
+// was set via --trace (everything is kept and written out as Chrome
+// trace JSON on exit), or the overlay is visible (only the last value
+// of each probe and the counters are kept).
+// Safe to use from any thread.
+class PerfTrace {
+public:
+    static PerfTrace *getInstance();
+
+    static bool enabled() {
+        return active.load(std::memory_order_relaxed);
+    }
+    qint64 now() const;
+
+    void setTraceFile(QString path);
+    void setCollecting(bool mode);
+    void addEvent(const char *name, const QString &detail, qint64 start, qint64 duration);
+    void count(const char *name);
+    // write collected events to the trace file, if any
+    bool writeTrace();
+
+    // for the overlay
+    QMap<QString, qint64> lastTimings();
+    QMap<QString, qint64> counters();
+
+private:
+    PerfTrace();
+    void updateActive();
+
+    static std::atomic<bool> active;
+    QElapsedTimer clock;
+    QMutex mutex;
+    QString traceFile;
+    bool collecting;
+    std::vector<PerfEvent> events;
+    QHash<QString, qint64> last, counts;
+
+    const size_t MAX_EVENTS = 2000000;
+};
+
+// Times its own lifetime and reports it as one event.
+class PerfScope {
+public:
+    explicit PerfScope(const char *_name, const QString &_detail = QString())
+        : name(_name),
+          start(-1)
+    {
+        if(PerfTrace::enabled()) {
+            detail = _detail;
+            start = PerfTrace::getInstance()->now();
+        }
+    }
+    ~PerfScope() {
+        if(start >= 0)
+            PerfTrace::getInstance()->addEvent(name, detail, start, PerfTrace::getInstance()->now() - start);
+    }
+private:
+    const char *name;
+    QString detail;
+    qint64 start;
+};
+
+inline void perfCount(const char *name) {
+    if(PerfTrace::enabled())
+        PerfTrace::getInstance()->count(name);
+}
@@ -1,79 +1,171 @@
 #include "randomizer.h"
 
-Randomizer::Randomizer() {
-    setCount(0);
+Randomizer::Randomizer()
+    : currentIndex(0),
+      removedCount(0),
+      rng(static_cast<std::mt19937::result_type>(std::chrono::steady_clock::now().time_since_epoch().count()))
+{
 }
 
-Randomizer::Randomizer(int _count) : currentIndex(0) {
-    setCount(_count);
+void Randomizer::reset(const QStringList &items) {
+    vec.assign(items.begin(), items.end());
+    removedCount = 0;
+    currentIndex = 0;
+    shuffle();
 }
 
-void Randomizer::setCount(int _count) {
-    vec.resize(_count);
-    fill();
+// goes to a random spot among the ones we haven't visited yet
+void Randomizer::insert(const QString &item) {
+    if(item.isEmpty() || position.contains(item))
+        return;
+    vec.push_back(item);
+    int last = static_cast<int>(vec.size()) - 1;
+    position.insert(item, last);
+    int first = qMin(currentIndex + 1, last);
+    std::uniform_int_distribution<int> dist(first, last);
+    int slot = dist(rng);
+    if(slot != last) {
+        QString tmp = vec[slot];
+        place(item, slot);
+        place(tmp, last);
+    }
 }
 
-void Randomizer::shuffle() {
-    std::mt19937 rng(std::chrono::steady_clock::now().time_since_epoch().count());
-    std::shuffle(vec.begin(), vec.end(), rng);
+void Randomizer::remove(const QString &item) {
+    auto it = position.find(item);
+    if(it == position.end())
+        return;
+    vec[it.value()].clear();
+    position.erase(it);
+    removedCount++;
+    if(removedCount > static_cast<int>(vec.size()) / 2)
+        compact();
 }
 
-void Randomizer::setCurrent(int _current) {
-    currentIndex = indexOf(_current);
+void Randomizer::rename(const QString &from, const QString &to) {
+    auto it = position.find(from);
+    if(it == position.end() || position.contains(to))
+        return;
+    int index = it.value();
+    position.erase(it);
+    place(to, index);
 }
 
-// this assumes our array contains shuffled int values [0 ... count]
-// which it does in our case
-int Randomizer::indexOf(int item) {
-    int index = -1;
-    if(item >= vec.size())
-        return index;
-    std::vector<int>::iterator it;
-    int i = 0;
-    for (it = vec.begin(); it != vec.end(); ++it, ++i) {
-        if(vec[i] == item) {
-            index = i;
-            break;
-        }
-    }
-    return index;
+bool Randomizer::setCurrent(const QString &item) {
+    auto it = position.constFind(item);
+    if(it == position.constEnd())
+        return false;
+    currentIndex = it.value();
+    return true;
+}
+
+int Randomizer::count() const {
+    return position.count();
+}
+
+// Full reshuffle. Also drops removed slots.
+void Randomizer::shuffle() {
+    vec.erase(std::remove(vec.begin(), vec.end(), QString()), vec.end());
+    removedCount = 0;
+    std::shuffle(vec.begin(), vec.end(), rng);
+    position.clear();
+    position.reserve(static_cast<int>(vec.size()));
+    for(int i = 0; i < static_cast<int>(vec.size()); i++)
+        position.insert(vec[i], i);
 }
 
-void Randomizer::fill() {
-    std::vector<int>::iterator it;
-    int i = 0;
-    for (it = vec.begin(); it != vec.end(); ++it, ++i) {
-        *it = i;
+// drop removed slots, keeping the order (and history)
+void Randomizer::compact() {
+    int newCurrent = 0, j = 0;
+    for(int i = 0; i < static_cast<int>(vec.size()); i++) {
+        if(i == currentIndex)
+            newCurrent = qMax(j - (vec[i].isEmpty() ? 1 : 0), 0);
+        if(vec[i].isEmpty())
+            continue;
+        if(i != j)
+            place(vec[i], j);
+        j++;
     }
+    vec.resize(j);
+    removedCount = 0;
+    currentIndex = qMin(newCurrent, qMax(j - 1, 0));
+}
+
+void Randomizer::place(const QString &item, int index) {
+    vec[index] = item;
+    if(!item.isEmpty())
+        position.insert(item, index);
 }
 
 void Randomizer::print() {
     qDebug() << "---vector---";
-    std::vector<int>::iterator it;
-    for (it = vec.begin(); it != vec.end(); ++it) {
-        std::cout << *it << std::endl;
-    }
+    for(auto &item : vec)
+        std::cout << item.toStdString() << std::endl;
     qDebug() << "----end----";
 }
 
-int Randomizer::next() {
-    // re-shuffle when needed
+QString Randomizer::next() {
+    if(position.isEmpty())
+        return QString();
+    int size = static_cast<int>(vec.size());
+    for(int i = currentIndex + 1; i < size; i++) {
+        if(!vec[i].isEmpty()) {
+            currentIndex = i;
+            return vec[i];
+        }
+    }
+    // reached the end; new round with the current item in front
     // because vector gets rearranged this will break prev()
-    while(currentIndex == vec.size() - 1) {
-        int currentItem = vec[currentIndex];
-        shuffle();
-        setCurrent(currentItem);
+    QString currentItem = (currentIndex < size) ? vec[currentIndex] : QString();
+    shuffle();
+    currentIndex = 0;
+    if(position.contains(currentItem) && vec.size() > 1) {
+        int index = position.value(currentItem);
+        QString tmp = vec[0];
+        place(currentItem, 0);
+        place(tmp, index);
+        currentIndex = 1;
     }
-    currentIndex++;
     return vec[currentIndex];
 }
 
-int Randomizer::prev() {
-    while(currentIndex == 0) {
-        int currentItem = vec[currentIndex];
-        shuffle();
-        setCurrent(currentItem);
+QString Randomizer::prev() {
+    if(position.isEmpty())
+        return QString();
+    for(int i = qMin(currentIndex, static_cast<int>(vec.size())) - 1; i >= 0; i--) {
+        if(!vec[i].isEmpty()) {
+            currentIndex = i;
+            return vec[i];
+        }
+    }
+    // reached the start; new round with the current item at the back
+    int size = static_cast<int>(vec.size());
+    QString currentItem = (currentIndex < size) ? vec[currentIndex] : QString();
+    shuffle();
+    int last = static_cast<int>(vec.size()) - 1;
+    currentIndex = last;
+    if(position.contains(currentItem) && vec.size() > 1) {
+        int index = position.value(currentItem);
+        QString tmp = vec[last];
+        place(currentItem, last);
+        place(tmp, index);
+        currentIndex = last - 1;
     }
-    currentIndex--;
     return vec[currentIndex];
 }
+
+QString Randomizer::peekNext() const {
+    for(int i = currentIndex + 1; i < static_cast<int>(vec.size()); i++) {
+        if(!vec[i].isEmpty())
+            return vec[i];
+    }
+    return QString();
+}
+
+QString Randomizer::peekPrev() const {
+    for(int i = qMin(currentIndex, static_cast<int>(vec.size())) - 1; i >= 0; i--) {
+        if(!vec[i].isEmpty())
+            return vec[i];
+    }
+    return QString();
+}
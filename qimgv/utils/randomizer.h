@@ -8,22 +8,44 @@
 
 #include <QDebug>
 #include <QString>
+#include <QStringList>
+#include <QHash>
 
+// Shuffled playback order over file paths.
+//
+// Everything before the current position is history, so prev() works
+// until the order wraps around. Files can be added, removed or renamed
+// in O(1) without reshuffling: new files go to a random slot after the
+// current position, and removed ones leave an empty slot that gets
+// compacted once there are too many. Positions are found through
+// an inverse map instead of a scan.
 class Randomizer {
 public:
     Randomizer();
-    Randomizer(int _count);
 
-    void setCount(int _count);
-    int next();
-    int prev();
+    // starts over with a fresh order
+    void reset(const QStringList &items);
+    void insert(const QString &item);
+    void remove(const QString &item);
+    void rename(const QString &from, const QString &to);
+    bool setCurrent(const QString &item);
+    int count() const;
+
+    QString next();
+    QString prev();
+    // what next() / prev() would return; empty if that needs a reshuffle
+    QString peekNext() const;
+    QString peekPrev() const;
 
-    void shuffle();
     void print();
-    void setCurrent(int _current);
 private:
     int currentIndex;
-    std::vector<int> vec;
-    void fill();
-    int indexOf(int n);
+    std::vector<QString> vec; // empty string marks a removed slot
+    QHash<QString, int> position;
+    int removedCount;
+    std::mt19937 rng;
+
+    void shuffle();
+    void compact();
+    void place(const QString &item, int index);
 };